@@ -1,35 +1,73 @@
 #include "AircraftFactory.h"
 
 #include "aircraft.hpp"
+#include "AircraftManager.hpp"
+#include "aircraft_sprites.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <fstream>
+#include <limits>
+#include <stdexcept>
 
 AircraftFactory::AircraftFactory()
 {
-    aircraft_types.emplace_back(std::make_unique<AircraftType>( .02f, .05f, .02f, .5f, 3'000, MediaPath { "l1011_48px.png" } ));
-    aircraft_types.emplace_back(std::make_unique<AircraftType>( .02f, .05f, .02f, .2f, 2'500, MediaPath { "b707_jat.png"} ));
-    aircraft_types.emplace_back(std::make_unique<AircraftType>( .02f, .1f, .02f, 1.f, 5'000, MediaPath { "concorde_af.png" } ));
+    register_type(AircraftType { .02f, .05f, .02f, .5f, 3'000 }, MediaPath { "l1011_48px.png" });
+    register_type(AircraftType { .02f, .05f, .02f, .2f, 2'500 }, MediaPath { "b707_jat.png"});
+    register_type(AircraftType { .02f, .1f, .02f, 1.f, 5'000 }, MediaPath { "concorde_af.png" });
     assert(aircraft_types.size() == 3);
+    set_type_mix(std::vector<double>(aircraft_types.size(), 1.));
 }
-std::unique_ptr<Aircraft> AircraftFactory::create_aircraft(Tower& tower)
+Aircraft& AircraftFactory::create_aircraft(Tower& tower, AircraftManager& manager)
 {
     const std::string flight_number = new_flight_number();
     const float angle       = (std::rand() % 1000) * 2 * 3.141592f / 1000.f; // random angle between 0 and 2pi
     const Point3D start     = Point3D { std::sin(angle), std::cos(angle), 0.f } * 3 + Point3D { 0.f, 0.f, 2.f };
     const Point3D direction = (-start).normalize();
-    const AircraftType& type = *aircraft_types[std::rand() % aircraft_types.size()];
+    const auto type = static_cast<AircraftTypeId>(type_mix(engine));
 
-    return std::make_unique<Aircraft>(type, flight_number, start, direction, tower);
+    return manager.acquire(type, flight_number, start, direction, tower);
+}
+
+void AircraftFactory::create_aircrafts(Tower& tower, AircraftManager& manager, const size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        create_aircraft(tower, manager);
+    }
+}
+
+void AircraftFactory::set_type_mix(const std::vector<double>& weights)
+{
+    if (weights.size() != aircraft_types.size())
+        throw std::invalid_argument {"The traffic mix needs one weight per aircraft type!"};
+    if (std::any_of(weights.begin(), weights.end(), [](double w) { return !std::isfinite(w) || w <= 0; }))
+        throw std::invalid_argument {"The weights of the traffic mix must be finite and greater than zero!"};
+    type_mix = std::discrete_distribution<size_t> {weights.begin(), weights.end()};
+}
+
+void AircraftFactory::register_type(const AircraftType& type, const MediaPath& sprite)
+{
+    assert(aircraft_types.size() < std::numeric_limits<AircraftTypeId>::max());
+    const auto id = static_cast<AircraftTypeId>(aircraft_types.size());
+    aircraft_types.emplace_back(type);
+    GL::register_aircraft_sprite(id, sprite);
 }
 
 std::string AircraftFactory::new_flight_number()
 {
-    std::string flight_number;
+    const size_t airline_idx = std::rand() % airlines.size();
+    if (used_flight_number_count >= used_flight_numbers.size() / 2) {   // Too many collisions -> sequential numbers
+        return airlines[airline_idx] + std::to_string(next_sequential_number++);
+    }
+    // airlines sharing the same code share their numbers
+    const auto code_idx = std::distance(airlines.begin(), std::find(airlines.begin(), airlines.end(), airlines[airline_idx]));
+    unsigned number;
     do {
-        flight_number = airlines[std::rand() % airlines.size()] + std::to_string(1000 + (rand() % 9000));
-    } while (flight_numbers.find(flight_number) != flight_numbers.end());
-    flight_numbers.emplace(flight_number);
-    return flight_number;
+        number = rand() % 9000;
+    } while (used_flight_numbers[code_idx * 9000 + number]);
+    used_flight_numbers[code_idx * 9000 + number] = true;
+    used_flight_number_count++;
+    return airlines[airline_idx] + std::to_string(1000 + number);
 }
 
 std::unique_ptr<AircraftFactory> AircraftFactory::LoadTypes(const MediaPath& media)
@@ -45,11 +83,13 @@ AircraftFactory::AircraftFactory(std::ifstream& input)
 {
     assert(input.is_open());
     std::string line;
+    std::vector<double> weights;
     while (std::getline(input, line)) {
-        aircraft_types.emplace_back(parse_line(line));
+        weights.emplace_back(parse_line(line));
     }
+    set_type_mix(weights);
 }
-std::unique_ptr<AircraftType> AircraftFactory::parse_line(std::string& line)
+double AircraftFactory::parse_line(std::string& line)
 {
     size_t pos = 0;
     try {
@@ -68,8 +108,13 @@ std::unique_ptr<AircraftType> AircraftFactory::parse_line(std::string& line)
         const int fuel = std::stoi (line, &pos);
         line.erase(0, pos + 1);
 
-        return std::make_unique<AircraftType>(gSpeed, aSpeed, acc, consumption, fuel, MediaPath {line});
-    } catch (const std::invalid_argument& e) {
-        throw std::invalid_argument{"File format invalid. The should be 'float float float float int string"};
+        const auto sep = line.find(' ');                                    // Optional weight in the traffic mix
+        const double weight = sep == std::string::npos ? 1. : std::stod(line.substr(sep + 1));
+        line.erase(std::min(sep, line.size()));
+
+        register_type(AircraftType { gSpeed, aSpeed, acc, consumption, static_cast<unsigned>(fuel) }, MediaPath {line});
+        return weight;
+    } catch (const std::logic_error&) {                                    // Not a number, or out of range
+        throw std::invalid_argument{"File format invalid. The should be 'float float float float int string [float]"};
     }
 }
@@ -2,12 +2,15 @@
 
 #include <ostream>
 #include <fstream>
+#include <random>
 #include <vector>
 #include <memory>
 
 #include "aircraft_types.hpp"
+#include "img/media_path.hpp"
 
 class Aircraft;
+class AircraftManager;
 class Tower;
 
 inline std::array<std::string, 8> airlines { "AF", "LH", "EY", "DL", "KL", "BA", "AY", "EY" };
@@ -23,12 +26,24 @@ public:
     explicit AircraftFactory(std::ifstream&);
     static std::unique_ptr<AircraftFactory> LoadTypes(const MediaPath&);
 
-    std::unique_ptr<Aircraft> create_aircraft(Tower& tower);
+    // the aircraft are stored (and recycled) by the manager
+    Aircraft& create_aircraft(Tower& tower, AircraftManager& manager);
+    // create `count` aircraft at once, their types following the traffic mix
+    void create_aircrafts(Tower& tower, AircraftManager& manager, size_t count);
+    // set the relative frequency of each type in the traffic (one weight per type)
+    void set_type_mix(const std::vector<double>& weights);
+    [[nodiscard]] size_t type_count() const { return aircraft_types.size(); }
 private:
-    static std::unique_ptr<AircraftType> parse_line(std::string&);
+    // parse an aircraft type and return its weight in the traffic mix
+    static double parse_line(std::string&);
+    // add a type to the type table and its sprite to the render registry
+    static void register_type(const AircraftType&, const MediaPath& sprite);
 
     std::string new_flight_number();
 
-    std::vector<std::unique_ptr<AircraftType>> aircraft_types;
-    std::unordered_set<std::string> flight_numbers;
+    std::vector<bool> used_flight_numbers = std::vector<bool>(airlines.size() * 9000);  // One bit per airline and number
+    size_t used_flight_number_count = 0;
+    unsigned next_sequential_number = 10'000;       // Used once the random flight numbers become scarce
+    std::mt19937 engine { static_cast<unsigned>(std::rand()) };
+    std::discrete_distribution<size_t> type_mix;
 };
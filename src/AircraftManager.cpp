@@ -1,59 +1,204 @@
 #include "AircraftManager.hpp"
 
 #include "aircraftCrash.hpp"
+#include "allocation.hpp"
+#include "GL/heatmap.hpp"
+#include "GL/perf_hud.hpp"
+#include "GL/trails.hpp"
 #include <numeric>
 #include <algorithm>
 
 AircraftManager::AircraftManager()
 {
     GL::move_queue.emplace(this);
+    lifecycle.subscribe(flight_log);
 }
 
-bool AircraftManager::move_aircraft(double dt, Aircraft& craft) {
-    assert(dt > 0);
+bool AircraftManager::is_due(const Aircraft& craft) const
+{
+    return (tick + craft.stagger) % craft.update_period == 0;
+}
+
+bool AircraftManager::fly(Aircraft& craft, const double tick_dt) {
+    const double dt  = craft.pending_dt;
+    craft.pending_dt = 0;
     try {
-        return craft.move(dt);
+        if (craft.fly(dt)) {
+            lifecycle.publish(LifecycleKind::departed, craft);
+            return true;
+        }
     } catch (const AircraftCrash& crash) {
-        std::cerr << crash.what() << std::endl;
-        crash_count++;
+        alloc::mark_unsteady();                                 // Building the crash reports allocates
+        craft.crash_reason = crash.get_reason();                // Reported by the flight log
+        lifecycle.publish(LifecycleKind::crashed, craft);
         return true;
     }
+    if (craft.is_parked()) lifecycle.publish(LifecycleKind::arrived_at_terminal, craft);
+    craft.update_period = craft.next_update_period(tick_dt);
+    return false;
 }
 
 [[maybe_unused]] void AircraftManager::display_aircrafts() { // Debug function
     std::cout << "---" << std::endl;
-    std::for_each(aircrafts.begin(), aircrafts.end(), [](const std::unique_ptr<Aircraft>& a){std::cout << *a << std::endl;});
+    for (const auto& aircrafts: groups) {
+        std::for_each(aircrafts.begin(), aircrafts.end(), [](const Aircraft* a){std::cout << *a << std::endl;});
+    }
     std::cout << "---" << std::endl;
 }
 
+template<typename Kernel>
+void AircraftManager::move_group(const FlightPhase phase, const double dt, Kernel&& kernel, Batch& retired,
+                                 Batch& changed)
+{
+    Group& aircrafts = group(phase);
+    aircrafts.erase(std::remove_if(aircrafts.begin(), aircrafts.end(), [&](Aircraft* a) {
+        a->start_tick();
+        a->pending_dt += dt;                                    // Flown when the aircraft is due
+        if (a->phase() != phase) {                              // Changed by the tower since the last tick
+            a->glide();
+            changed.emplace_back(a);
+            return true;
+        }
+        if (kernel(*a)) {
+            retired.emplace_back(a);
+            return true;
+        }
+        a->glide();
+        a->update_overlays();
+        if (a->phase() == phase) return false;
+        changed.emplace_back(a);
+        return true;
+    }), aircrafts.end());
+}
+
 void AircraftManager::move(const double dt)
 {
     assert(dt > 0);
-    std::sort(aircrafts.begin(), aircrafts.end(),
-              [](const std::unique_ptr<Aircraft>& a, const std::unique_ptr<Aircraft>& b){return *a < *b;});
+    const alloc::PhaseGuard phase { alloc::Phase::aircraft };
+    const GL::StageTimer timer { GL::Stage::aircraft };
 //    display_aircrafts();
-    aircrafts.erase(std::remove_if(aircrafts.begin(), aircrafts.end(),
-                  [this, dt](const std::unique_ptr<Aircraft>& a){return move_aircraft(dt, *a);}), aircrafts.end());
+    Batch retired { &alloc::tick_arena() };                     // Released once every aircraft has moved
+    Batch changed { &alloc::tick_arena() };                     // Regrouped once every group has moved
+
+    move_group(FlightPhase::holding, dt, [this, dt](Aircraft& a) {
+        a.track_holding();                                      // Culled like the other aircraft
+        if (!is_due(a) || a.current_fuel() > 0) return false;
+        a.leave_holding();                                      // Out of fuel, crashes in fly()
+        return fly(a, dt);
+    }, retired, changed);
+    move_group(FlightPhase::inbound, dt, [this, dt](Aircraft& a) {
+        if (!is_due(a)) return false;
+        if (a.needs_terminal() && a.distance_to(a.control->get_position()) < AIRPORT_AREA_RADIUS) {
+            a.control->request_terminal(a);                     // Register once, the path is pushed later
+        }
+        return fly(a, dt);
+    }, retired, changed);
+    move_group(FlightPhase::approach, dt, [this, dt](Aircraft& a) { return is_due(a) && fly(a, dt); },
+               retired, changed);
+    move_group(FlightPhase::at_gate, dt, [](Aircraft& a) {
+        a.pending_dt = 0;                                       // Released by the tower's events
+        return false;
+    }, retired, changed);
+    move_group(FlightPhase::departing, dt, [this, dt](Aircraft& a) { return is_due(a) && fly(a, dt); },
+               retired, changed);
+
+    tick++;
+    if (GL::heatmap_enabled) accumulate_heat(dt);
+    std::for_each(changed.begin(), changed.end(), [this](Aircraft* a){add_to_group(*a);});
+    lifecycle.dispatch();                                       // Before the retired aircraft are recycled
+    std::for_each(retired.begin(), retired.end(), [this](Aircraft* a){release(*a);});
+}
+
+void AircraftManager::accumulate_heat(const double dt) const
+{
+    GL::heatmap.decay(dt);
+    for (const auto& aircrafts: groups) {
+        for (const Aircraft* a: aircrafts) GL::heatmap.add(project_2D(a->current_position()), dt);
+    }
+}
+
+void AircraftManager::add_to_group(Aircraft& aircraft)
+{
+    Group& aircrafts = group(aircraft.phase());
+    if (aircrafts.size() == aircrafts.capacity()) alloc::mark_unsteady();
+    aircrafts.emplace_back(&aircraft);
 }
-void AircraftManager::add_aircraft(std::unique_ptr<Aircraft> aircraft)
+
+Aircraft& AircraftManager::acquire(const AircraftTypeId type, const std::string_view& flight_number,
+                                   const Point3D& pos, const Point3D& speed, Tower& control)
+{
+    Aircraft* aircraft;
+    if (free_aircrafts.empty()) {
+        alloc::mark_unsteady();                                 // The pool grows
+        aircraft = &pool.emplace_back(type, flight_number, pos, speed, control);
+        aircraft->handle = { static_cast<std::uint32_t>(pool.size() - 1), 0 };
+    } else {
+        aircraft = free_aircrafts.back();
+        free_aircrafts.pop_back();
+        aircraft->reset(type, flight_number, pos, speed, control);
+    }
+    aircraft->stagger = next_stagger++;
+    GL::trails.clear(aircraft->handle.slot);                    // Nothing left of the previous flight of the slot
+    add_to_group(*aircraft);
+    return *aircraft;
+}
+
+void AircraftManager::release(Aircraft& aircraft)
+{
+    aircraft.retire();
+    aircraft.handle.generation++;                               // The handles to this flight are now stale
+    if (free_aircrafts.size() == free_aircrafts.capacity()) alloc::mark_unsteady();
+    free_aircrafts.emplace_back(&aircraft);
+}
+
+void AircraftManager::reserve(const size_t capacity)
+{
+    group(FlightPhase::inbound).reserve(capacity);           // Most of the traffic waits in these two
+    group(FlightPhase::holding).reserve(capacity);
+    free_aircrafts.reserve(capacity);
+}
+
+Aircraft* AircraftManager::get(const AircraftHandle handle)
+{
+    if (handle.slot >= pool.size()) return nullptr;
+    Aircraft& aircraft = pool[handle.slot];
+    return aircraft.handle == handle && aircraft.active ? &aircraft : nullptr;
+}
+
+size_t AircraftManager::count() const
 {
-    assert(aircraft != nullptr);
-    aircrafts.emplace_back(std::move(aircraft));
+    return std::accumulate(groups.begin(), groups.end(), size_t {0},
+                           [](size_t x, const Group& aircrafts){ return x + aircrafts.size(); });
+}
+
+template<typename Function>
+unsigned AircraftManager::count_if(Function&& predicate) const
+{
+    return std::accumulate(groups.begin(), groups.end(), 0u, [&predicate](unsigned x, const Group& aircrafts) {
+        return x + std::count_if(aircrafts.begin(), aircrafts.end(), predicate);
+    });
 }
 
 unsigned AircraftManager::count_aircraft_on_airline(const std::string_view& line)
 {
-    return std::count_if(aircrafts.begin(), aircrafts.end(),
-        [line](const std::unique_ptr<Aircraft>& a){return (a->get_flight_num().rfind(line, 0) == 0);});
+    return count_if([line](const Aircraft* a){return (a->get_flight_num().rfind(line, 0) == 0);});
 }
 
-unsigned AircraftManager::get_required_fuel() {
-    return std::accumulate(aircrafts.begin(), aircrafts.end(), 0,
-           [](unsigned x, const std::unique_ptr<Aircraft>& a){
-               return a->is_low_on_fuel() && a->is_circling() ? a->get_missing_fuel() + x : x;
-           });
+unsigned AircraftManager::forecast_fuel_demand(const double horizon) const {
+    assert(horizon >= 0);
+    unsigned demand = 0;
+    for (const auto phase: { FlightPhase::inbound, FlightPhase::holding, FlightPhase::approach }) {
+        const Group& aircrafts = group(phase);                  // Only the inbound phases will need fuel
+        demand = std::accumulate(aircrafts.begin(), aircrafts.end(), demand,
+               [horizon](unsigned x, const Aircraft* a){
+                   const AircraftType& type = a->type();
+                   const double remaining   = std::max(0., a->time_to_empty() - horizon) * type.fuel_consumption;
+                   return remaining < type.min_fuel ? x + type.max_fuel - static_cast<unsigned>(remaining) : x;
+               });
+    }
+    return demand;
 }
 
 void AircraftManager::display_crash_number() const {
-    std::cout << crash_count << " aircraft(s) have crashed so far." << std::endl;
+    flight_log.display_counts();
 }
@@ -1,10 +1,15 @@
 #pragma once
 
+#include <array>
+#include <deque>
+#include <memory_resource>
 #include <ostream>
 #include <vector>
 #include <memory>
 #include "aircraft.hpp"
 #include "GL/dynamic_object.hpp"
+#include "flight_log.hpp"
+#include "lifecycle_bus.hpp"
 
 class Aircraft;
 
@@ -16,15 +21,51 @@ public:
     AircraftManager(const AircraftManager&) = delete;
     AircraftManager& operator=(const AircraftManager&) = delete;
 
-    void add_aircraft(std::unique_ptr<Aircraft>);
+    // get a new aircraft, recycling the slot of a retired one if possible
+    Aircraft& acquire(AircraftTypeId type, const std::string_view& flight_number, const Point3D& pos,
+                      const Point3D& speed, Tower& control);
+    void reserve(size_t capacity);
+    // the aircraft referenced by the handle, or nullptr once its flight is over
+    [[nodiscard]] Aircraft* get(AircraftHandle handle);
     void move(double) override;
+    // landings at a terminal, departures and crashes of the tick (dispatched at the end of move())
+    LifecycleBus& get_lifecycle_bus() { return lifecycle; }
     unsigned count_aircraft_on_airline(const std::string_view&);
-    unsigned get_required_fuel();
+    // fuel needed by the inbound aircraft that will be low on fuel within `horizon`
+    [[nodiscard]] unsigned forecast_fuel_demand(double horizon) const;
     void display_crash_number() const;
+    [[nodiscard]] size_t count() const;
+    [[nodiscard]] size_t count_airborne() const { return count() - group(FlightPhase::at_gate).size(); }
+    [[nodiscard]] size_t count_in_phase(const FlightPhase phase) const { return group(phase).size(); }
 private:
-    std::vector<std::unique_ptr<Aircraft>> aircrafts;
-    unsigned crash_count = 0;
+    using Group = std::vector<Aircraft*>;
+    using Batch = std::pmr::vector<Aircraft*>;
+
+    std::deque<Aircraft> pool;                  // Storage of every aircraft, indexed by the handles' slot
+    std::vector<Aircraft*> free_aircrafts;      // Retired aircraft waiting to be recycled
+    std::array<Group, static_cast<size_t>(FlightPhase::count)> groups;    // Live aircraft, by flight phase
+    LifecycleBus lifecycle;
+    FlightLog flight_log;                       // Reports the crashes, counts them and the departures
+    unsigned long tick   = 0;
+    unsigned next_stagger = 0;
+
+    [[nodiscard]] Group& group(const FlightPhase phase) { return groups[static_cast<size_t>(phase)]; }
+    [[nodiscard]] const Group& group(const FlightPhase phase) const { return groups[static_cast<size_t>(phase)]; }
+    void add_to_group(Aircraft& aircraft);
+    template<typename Function>
+    [[nodiscard]] unsigned count_if(Function&& predicate) const;
+
+    // add dt to the pending time of the group of `phase` and run `kernel` over it, the aircraft that
+    // changed phase are moved to `changed`
+    template<typename Kernel>
+    void move_group(FlightPhase phase, double dt, Kernel&& kernel, Batch& retired, Batch& changed);
+    // tell if the aircraft moves during this tick (move_group accumulates its time every tick)
+    [[nodiscard]] bool is_due(const Aircraft& craft) const;
+    // integrate the time accumulated by the aircraft, return true if it has to be destroyed
+    bool fly(Aircraft& craft, double tick_dt);
+    // time spent by every aircraft at its position during the tick (density overlay)
+    void accumulate_heat(double dt) const;
 
     [[maybe_unused]] void display_aircrafts();
-    bool move_aircraft(double dt, Aircraft &craft);
+    void release(Aircraft&);
 };
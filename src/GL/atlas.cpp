@@ -0,0 +1,124 @@
+#include "atlas.hpp"
+
+#include "opengl_interface.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+namespace GL {
+
+namespace {
+
+unsigned next_power_of_two(const unsigned x)
+{
+    unsigned p = 1;
+    while (p < x) p <<= 1;
+    return p;
+}
+
+// copy the columns [first, first + count) of the image at (x, y) in the RGBA atlas, whatever its number of channels
+void blit(const img::Image& image, const unsigned first, const unsigned count, std::vector<unsigned char>& pixels,
+          const unsigned atlas_width, const unsigned x, const unsigned y)
+{
+    const unsigned channels    = image.get_pixel_size();
+    const unsigned char* input = image.get_data();
+    for (unsigned row = 0; row < image.get_height(); row++) {
+        for (unsigned col = 0; col < count; col++) {
+            const unsigned char* src = input + (row * image.get_width() + first + col) * channels;
+            unsigned char* dst       = pixels.data() + ((y + row) * atlas_width + x + col) * 4;
+            const bool gray          = channels < 3;
+            dst[0] = src[0];
+            dst[1] = gray ? src[0] : src[1];
+            dst[2] = gray ? src[0] : src[2];
+            dst[3] = channels == 4 ? src[3] : channels == 2 ? src[1] : 255;
+        }
+    }
+}
+
+} // namespace
+
+TextureAtlas::~TextureAtlas()
+{
+    if (tex_index != 0) glDeleteTextures(1, &tex_index);
+}
+
+const AtlasRegion& TextureAtlas::add(std::unique_ptr<const img::Image> image, const unsigned tiles)
+{
+    assert(image && tex_index == 0);
+    if (!image->valid()) throw std::runtime_error { "Cannot load an image of the atlas" };
+    AtlasRegion& region = regions.emplace_back();
+    region.tiles        = tiles;
+    pending.push_back({ std::move(image), &region });
+    return region;
+}
+
+void TextureAtlas::build(const bool upload)
+{
+    assert(tex_index == 0 && pixels.empty());
+    std::sort(pending.begin(), pending.end(), [](const Pending& a, const Pending& b) {
+        return a.image->get_height() > b.image->get_height();
+    });
+    const auto padded      = [](const unsigned size) { return size + 2 * ATLAS_PADDING; };
+    const auto tile_width  = [](const Pending& p) { return p.image->get_width() / p.region->tiles; };
+    const auto sheet_width = [&](const Pending& p) { return p.region->tiles * padded(tile_width(p)); };
+    const unsigned widest = std::accumulate(pending.begin(), pending.end(), 1u, [&](unsigned w, const Pending& p) {
+        return std::max(w, sheet_width(p));
+    });
+    const unsigned area = std::accumulate(pending.begin(), pending.end(), 0u, [&](unsigned a, const Pending& p) {
+        return a + sheet_width(p) * padded(p.image->get_height());
+    });
+    width = next_power_of_two(std::max(widest, static_cast<unsigned>(std::ceil(std::sqrt(area)))));
+
+    // shelves: fill rows left to right, a new shelf starts below the tallest image of the current one
+    std::vector<std::pair<unsigned, unsigned>> places;
+    unsigned x = 0, y = 0, shelf_height = 0;
+    for (const auto& p : pending) {
+        assert(p.image->get_width() % p.region->tiles == 0);
+        const unsigned w = sheet_width(p), h = padded(p.image->get_height());
+        if (x + w > width) {
+            x = 0;
+            y += shelf_height;
+            shelf_height = 0;
+        }
+        places.emplace_back(x, y);
+        x += w;
+        shelf_height = std::max(shelf_height, h);
+    }
+    height = next_power_of_two(std::max(y + shelf_height, 1u));
+    if (width > ATLAS_MAX_SIZE || height > ATLAS_MAX_SIZE) throw std::runtime_error { "The sprites do not fit in the atlas" };
+
+    pixels.assign(static_cast<size_t>(width) * height * 4, 0);
+    for (size_t i = 0; i < pending.size(); i++) {
+        const img::Image& image = *pending[i].image;
+        AtlasRegion& region     = *pending[i].region;
+        const unsigned tile     = tile_width(pending[i]);
+        const unsigned px = places[i].first + ATLAS_PADDING, py = places[i].second + ATLAS_PADDING;
+        for (unsigned t = 0; t < region.tiles; t++) {
+            blit(image, t * tile, tile, pixels, width, px + t * padded(tile), py);
+        }
+        region.u0     = static_cast<float>(px) / width;
+        region.v0     = static_cast<float>(py) / height;
+        region.u1     = static_cast<float>(px + tile) / width;
+        region.v1     = static_cast<float>(py + image.get_height()) / height;
+        region.stride = static_cast<float>(padded(tile)) / width;
+    }
+
+    pending.clear();
+    if (!upload) return;
+
+    glGenTextures(1, &tex_index);
+    glBindTexture(GL_TEXTURE_2D, tex_index);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    gluBuild2DMipmaps(GL_TEXTURE_2D, GL_RGBA, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    // the padding only protects the first levels from the neighbouring tiles
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, ATLAS_MIP_LEVELS);
+    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    handle_error("Cannot create the texture atlas");
+    pixels = {};                                                // The pixels now live on the GPU only
+}
+
+} // namespace GL
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "../img/image.hpp"
+
+#include <GL/freeglut.h>
+#include <array>
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace GL {
+
+// Place of a sprite sheet in the atlas (the sheet is a row of `tiles` equal tiles, each padded on its own)
+struct AtlasRegion
+{
+    float u0 = 0.f, v0 = 0.f, u1 = 0.f, v1 = 0.f;   // the first tile
+    float stride   = 0.f;                           // from a tile to the next one, padding included
+    unsigned tiles = 1;
+
+    // texture coordinates {left, top, right, bottom} of a tile
+    [[nodiscard]] std::array<float, 4> tile_uv(const unsigned tile) const
+    {
+        return { u0 + tile * stride, v0, u1 + tile * stride, v1 };
+    }
+};
+
+// Every image drawn by the simulation packed in a single mipmapped texture, so that a frame is
+// drawn with one bind and one batch. The images are added while loading, then build() packs them
+// (shelf packing, tallest first, with ATLAS_PADDING pixels around every tile of a sheet so that the
+// mip levels do not mix neighbouring tiles), uploads the atlas and frees their pixels. Without a GL context
+// (headless runs) the packed pixels are kept for the software renderer instead.
+class TextureAtlas
+{
+public:
+    TextureAtlas() = default;
+    TextureAtlas(const TextureAtlas&) = delete;
+    TextureAtlas& operator=(const TextureAtlas&) = delete;
+    ~TextureAtlas();
+
+    // the region is filled by build(), its address never changes
+    const AtlasRegion& add(std::unique_ptr<const img::Image> image, unsigned tiles = 1);
+    void build(bool upload = true);
+    void bind() const { glBindTexture(GL_TEXTURE_2D, tex_index); }
+
+    // RGBA pixels of an atlas built without upload
+    [[nodiscard]] const std::vector<unsigned char>& get_pixels() const { return pixels; }
+    [[nodiscard]] unsigned get_width() const { return width; }
+    [[nodiscard]] unsigned get_height() const { return height; }
+
+private:
+    struct Pending
+    {
+        std::unique_ptr<const img::Image> image;
+        AtlasRegion* region;
+    };
+
+    std::deque<AtlasRegion> regions;
+    std::vector<Pending> pending;
+    GLuint tex_index = 0;
+    std::vector<unsigned char> pixels;
+    unsigned width  = 0;
+    unsigned height = 0;
+};
+
+inline TextureAtlas atlas;
+
+} // namespace GL
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "../config.hpp"
+#include "../geometry.hpp"
+
+#include <GL/freeglut.h>
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
+namespace GL {
+
+// Centre and half-size of the view, and size of the window it is drawn in. Changed by the GLUT
+// thread, read by the simulation thread to cull the snapshots and to size the labels (a view
+// mixing two updates only lasts one snapshot).
+class Camera
+{
+public:
+    void pan(const float dx, const float dy)
+    {
+        const float step = CAMERA_PAN_STEP * zoom.load();
+        x.store(x.load() + dx * step);
+        y.store(y.load() + dy * step);
+    }
+    void change_zoom(const float factor) { zoom.store(zoom.load() * factor); }
+    void resize(const int w, const int h)
+    {
+        width.store(std::max(w, 1));
+        height.store(std::max(h, 1));
+    }
+    void reset()
+    {
+        x.store(0.f);
+        y.store(0.f);
+        zoom.store(DEFAULT_ZOOM);
+    }
+
+    // GLUT thread: set the projection
+    void apply() const
+    {
+        const float cx = x.load(), cy = y.load(), half = zoom.load();
+        glMatrixMode(GL_PROJECTION);
+        glLoadIdentity();
+        glOrtho(cx - half, cx + half, cy - half, cy + half, 0.0f, 1.0f); // left, right, bottom, top, near, far
+    }
+
+    // corners of the view, widened by `margin`
+    [[nodiscard]] std::pair<Point2D, Point2D> view(const float margin) const
+    {
+        const float cx = x.load(), cy = y.load(), half = zoom.load() + margin;
+        return { Point2D { cx - half, cy - half }, Point2D { cx + half, cy + half } };
+    }
+
+    // size of a window pixel in screen coordinates
+    [[nodiscard]] Point2D pixel_size() const
+    {
+        const float size = 2.f * zoom.load();
+        return { size / width.load(), size / height.load() };
+    }
+
+private:
+    std::atomic<float> x { 0.f };
+    std::atomic<float> y { 0.f };
+    std::atomic<float> zoom { DEFAULT_ZOOM };
+    std::atomic<int> width { static_cast<int>(DEFAULT_WINDOW_WIDTH) };
+    std::atomic<int> height { static_cast<int>(DEFAULT_WINDOW_HEIGHT) };
+};
+
+inline Camera camera;
+
+} // namespace GL
@@ -1,5 +1,9 @@
 #pragma once
 
+#include "../allocation.hpp"
+#include "snapshot.hpp"
+#include "spatial_grid.hpp"
+
 #include <iostream>
 #include <vector>
 #include <algorithm>
@@ -11,22 +15,44 @@ namespace GL {
 
 class Displayable;
 
-inline std::vector<const Displayable*> display_queue;
+// every shown displayable, filed by screen position so that only the visible ones are drawn
+inline SpatialGrid display_grid;
 
 class Displayable
 {
 protected:
     float z = 0;
+    bool shown = false;
+    GridSlot slot;
+
+    // add to / remove from the display grid (used by recycled objects)
+    void show() {
+        if (shown) return;
+        display_grid.insert(this, slot, SpatialGrid::LOOSE);
+        shown = true;
+    }
+    void hide() {
+        if (!shown) return;
+        display_grid.erase(slot);
+        shown = false;
+    }
+    // file the object under its screen position (until then it is in the loose list, visited every snapshot)
+    void place(const Point2D& screen_pos) {
+        if (shown) display_grid.move(slot, display_grid.cell_of(screen_pos));
+    }
 
 public:
     explicit Displayable(const float z_) : z { z_ } {
-        display_queue.emplace_back(this);
+        show();
     }
+    Displayable(const Displayable&) = delete;
+    Displayable& operator=(const Displayable&) = delete;
     virtual ~Displayable() {
-        display_queue.erase(std::find(display_queue.begin(), display_queue.end(), this));
+        hide();
     };
 
-    virtual void display() const = 0;
+    // append what has to be drawn to the frame (called by the simulation thread after each tick)
+    virtual void display(Snapshot& frame) const = 0;
 
     [[nodiscard]] float get_z() const { return z; }
 };
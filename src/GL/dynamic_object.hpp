@@ -1,6 +1,7 @@
 #pragma once
 
-#include <unordered_set>
+#include <algorithm>
+#include <vector>
 
 namespace GL {
 
@@ -10,8 +11,66 @@ public:
     virtual ~DynamicObject() = default;
 
     virtual void move(double) = 0;
+    // number of ticks between two moves, the dt given to move() then covers all of them
+    [[nodiscard]] virtual unsigned update_period() const { return 1; }
 };
 
-inline std::unordered_set<DynamicObject*> move_queue;
+// Multi-rate scheduler of the dynamic objects
+// Each object moves every update_period() ticks with the time accumulated since its last move.
+// The objects sharing a period are staggered so that they do not all move during the same tick.
+class MoveQueue
+{
+public:
+    void emplace(DynamicObject* object)
+    {
+        const unsigned period = std::max(object->update_period(), 1u);
+        const auto same_period = std::count_if(entries.begin(), entries.end(),
+                [period](const Entry& e) { return e.period == period; });
+        entries.emplace_back(Entry { object, period, static_cast<unsigned>(same_period) % period, 0. });
+    }
+
+    void erase(DynamicObject* object)
+    {
+        entries.erase(std::remove_if(entries.begin(), entries.end(),
+                [object](const Entry& e) { return e.object == object; }), entries.end());
+    }
+
+    // one tick: move the objects that are due
+    void move(const double dt)
+    {
+        for (auto& entry : entries) {
+            entry.pending_dt += dt;
+            if ((tick + entry.offset) % entry.period != 0) continue;
+            entry.object->move(entry.pending_dt);
+            entry.pending_dt = 0;
+        }
+        tick++;
+    }
+
+    // move every object now, whatever its period (used to jump ahead in time)
+    void move_all(const double dt)
+    {
+        for (auto& entry : entries) {
+            entry.object->move(entry.pending_dt + dt);
+            entry.pending_dt = 0;
+        }
+    }
+
+    [[nodiscard]] size_t size() const { return entries.size(); }
+
+private:
+    struct Entry
+    {
+        DynamicObject* object;
+        unsigned period;
+        unsigned offset;
+        double pending_dt;
+    };
+
+    std::vector<Entry> entries;
+    unsigned long tick = 0;
+};
+
+inline MoveQueue move_queue;
 
 } // namespace GL
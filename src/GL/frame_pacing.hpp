@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace GL {
+
+using PacingClock = std::chrono::steady_clock;
+
+// Keeps a loop on a fixed schedule: each deadline is the previous one plus the period, so the
+// processing time does not drift the rate. After a stall of more than `max_lag` periods the
+// schedule restarts from now instead of running a burst of late iterations.
+class Pacer
+{
+public:
+    Pacer(const unsigned rate, const unsigned max_lag_) : max_lag { max_lag_ } { set_rate(rate); }
+
+    void set_rate(const unsigned rate)
+    {
+        period = std::chrono::duration_cast<PacingClock::duration>(std::chrono::duration<double>(1.0 / rate));
+    }
+
+    // the current iteration ends after its deadline (wait() woke up at `next`, the iteration is due one period later)
+    [[nodiscard]] bool is_late(const PacingClock::time_point now) const { return now > next + period; }
+
+    [[nodiscard]] PacingClock::time_point next_deadline() const { return next; }
+
+    // move to the next deadline and sleep until it
+    void wait()
+    {
+        const auto now = PacingClock::now();
+        next += period;
+        if (now - next > period * max_lag) next = now;
+        std::this_thread::sleep_until(next);
+    }
+
+    // render side: move to the next deadline without sleeping (GLUT does the waiting)
+    PacingClock::duration advance()
+    {
+        const auto now = PacingClock::now();
+        next += period;
+        if (now - next > period * max_lag) next = now;
+        return next > now ? next - now : PacingClock::duration::zero();
+    }
+
+private:
+    PacingClock::duration period {};
+    PacingClock::time_point next = PacingClock::now();
+    const unsigned max_lag;
+};
+
+// Rate of an event over the last second, written by one thread and read by any
+class RateMeter
+{
+public:
+    void add(const PacingClock::time_point now)
+    {
+        count++;
+        const auto elapsed = now - window_start;
+        if (elapsed < std::chrono::seconds { 1 }) return;
+        measured.store(count / std::chrono::duration<double>(elapsed).count(), std::memory_order_relaxed);
+        count        = 0;
+        window_start = now;
+    }
+
+    [[nodiscard]] double rate() const { return measured.load(std::memory_order_relaxed); }
+
+private:
+    unsigned count                      = 0;
+    PacingClock::time_point window_start = PacingClock::now();
+    std::atomic<double> measured { 0. };
+};
+
+} // namespace GL
@@ -0,0 +1,147 @@
+#include "frame_writer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace GL {
+
+namespace {
+
+constexpr size_t MAX_STORED_BLOCK = 65'535;
+
+std::uint32_t crc32(const std::uint8_t* data, const size_t size, std::uint32_t crc = 0)
+{
+    static const auto table = []() {
+        std::array<std::uint32_t, 256> t {};
+        for (std::uint32_t n = 0; n < t.size(); n++) {
+            std::uint32_t c = n;
+            for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[n] = c;
+        }
+        return t;
+    }();
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+// big-endian, as every integer of a PNG file
+void put_u32(std::uint8_t* out, const std::uint32_t value)
+{
+    for (int i = 0; i < 4; i++) out[i] = static_cast<std::uint8_t>(value >> (24 - 8 * i));
+}
+
+// length, type, data and CRC of the type and data, the chunk being sized up front
+void write_chunk(std::ofstream& file, const char* type, const std::vector<std::uint8_t>& data)
+{
+    std::vector<std::uint8_t> chunk(12 + data.size());
+    put_u32(chunk.data(), static_cast<std::uint32_t>(data.size()));
+    std::memcpy(chunk.data() + 4, type, 4);
+    if (!data.empty()) std::memcpy(chunk.data() + 8, data.data(), data.size());
+    put_u32(chunk.data() + 8 + data.size(), crc32(chunk.data() + 4, data.size() + 4));
+    file.write(reinterpret_cast<const char*>(chunk.data()), static_cast<std::streamsize>(chunk.size()));
+}
+
+} // namespace
+
+void write_png(const std::filesystem::path& path, const std::vector<std::uint8_t>& rgba, const unsigned width,
+               const unsigned height)
+{
+    assert(rgba.size() == static_cast<size_t>(width) * height * 4);
+    std::ofstream file { path, std::ios::binary };
+    if (!file) throw std::runtime_error { "Cannot write " + path.string() };
+
+    // raw scanlines, each preceded by its filter type (none)
+    const size_t stride = static_cast<size_t>(width) * 4;
+    std::vector<std::uint8_t> raw;
+    raw.reserve((stride + 1) * height);
+    for (unsigned row = 0; row < height; row++) {
+        raw.push_back(0);
+        raw.insert(raw.end(), rgba.begin() + row * stride, rgba.begin() + (row + 1) * stride);
+    }
+
+    // zlib stream made of stored blocks, followed by the Adler-32 of the raw data
+    std::vector<std::uint8_t> zlib { 0x78, 0x01 };
+    zlib.reserve(raw.size() + raw.size() / MAX_STORED_BLOCK * 5 + 16);
+    std::uint32_t a = 1, b = 0;
+    for (size_t offset = 0;; offset += MAX_STORED_BLOCK) {
+        const size_t size = std::min(MAX_STORED_BLOCK, raw.size() - offset);
+        const bool last   = offset + size == raw.size();
+        zlib.push_back(last ? 1 : 0);
+        zlib.push_back(static_cast<std::uint8_t>(size));
+        zlib.push_back(static_cast<std::uint8_t>(size >> 8));
+        zlib.push_back(static_cast<std::uint8_t>(~size));
+        zlib.push_back(static_cast<std::uint8_t>(~size >> 8));
+        for (size_t i = offset; i < offset + size; i++) {
+            a = (a + raw[i]) % 65'521;
+            b = (b + a) % 65'521;
+        }
+        zlib.insert(zlib.end(), raw.begin() + offset, raw.begin() + offset + size);
+        if (last) break;
+    }
+    zlib.resize(zlib.size() + 4);
+    put_u32(zlib.data() + zlib.size() - 4, (b << 16) | a);
+
+    static constexpr std::array<std::uint8_t, 8> signature { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    file.write(reinterpret_cast<const char*>(signature.data()), signature.size());
+    std::vector<std::uint8_t> header(13);
+    put_u32(header.data(), width);
+    put_u32(header.data() + 4, height);
+    header[8] = 8;                                          // 8 bits per channel
+    header[9] = 6;                                          // RGBA, then deflate, no filter and no interlace (0)
+    write_chunk(file, "IHDR", header);
+    write_chunk(file, "IDAT", zlib);
+    write_chunk(file, "IEND", {});
+    if (!file) throw std::runtime_error { "Cannot write " + path.string() };
+}
+
+Y4mWriter::Y4mWriter(const std::filesystem::path& path, const unsigned width_, const unsigned height_,
+                     const unsigned rate_num, const unsigned rate_den) :
+    file { path, std::ios::binary }, width { width_ }, height { height_ },
+    planes(static_cast<size_t>(width_) * height_ * 3 / 2)
+{
+    if (width % 2 != 0 || height % 2 != 0) throw std::invalid_argument { "4:2:0 video needs even dimensions" };
+    if (!file) throw std::runtime_error { "Cannot write " + path.string() };
+    file << "YUV4MPEG2 W" << width << " H" << height << " F" << rate_num << ':' << rate_den << " Ip A1:1 C420jpeg\n";
+}
+
+void Y4mWriter::write(const std::vector<std::uint8_t>& rgba)
+{
+    assert(rgba.size() == static_cast<size_t>(width) * height * 4);
+    std::uint8_t* luma = planes.data();
+    std::uint8_t* u    = luma + static_cast<size_t>(width) * height;
+    std::uint8_t* v    = u + static_cast<size_t>(width / 2) * (height / 2);
+    for (size_t i = 0; i < static_cast<size_t>(width) * height; i++) {
+        const int r = rgba[i * 4], g = rgba[i * 4 + 1], b = rgba[i * 4 + 2];
+        luma[i]     = static_cast<std::uint8_t>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+    }
+    // the chroma of each 2x2 block is computed from its mean color
+    for (unsigned y = 0; y < height / 2; y++) {
+        for (unsigned x = 0; x < width / 2; x++) {
+            int r = 0, g = 0, b = 0;
+            for (const unsigned dy : { 0u, 1u }) {
+                for (const unsigned dx : { 0u, 1u }) {
+                    const size_t p = ((2 * y + dy) * static_cast<size_t>(width) + 2 * x + dx) * 4;
+                    r += rgba[p];
+                    g += rgba[p + 1];
+                    b += rgba[p + 2];
+                }
+            }
+            r /= 4;
+            g /= 4;
+            b /= 4;
+            const size_t c = static_cast<size_t>(y) * (width / 2) + x;
+            u[c] = static_cast<std::uint8_t>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+            v[c] = static_cast<std::uint8_t>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+        }
+    }
+    file << "FRAME\n";
+    file.write(reinterpret_cast<const char*>(planes.data()), static_cast<std::streamsize>(planes.size()));
+    if (!file) throw std::runtime_error { "Cannot write a frame of the video" };
+}
+
+} // namespace GL
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace GL {
+
+// write an RGBA image as a PNG (stored deflate blocks: larger files, but no compression library)
+void write_png(const std::filesystem::path& path, const std::vector<std::uint8_t>& rgba, unsigned width, unsigned height);
+
+// YUV4MPEG2 video (4:2:0, BT.601 studio range) of RGBA frames, playable and encodable by ffmpeg
+class Y4mWriter
+{
+public:
+    // frame rate of rate_num / rate_den frames per second
+    Y4mWriter(const std::filesystem::path& path, unsigned width_, unsigned height_, unsigned rate_num, unsigned rate_den);
+
+    void write(const std::vector<std::uint8_t>& rgba);
+
+private:
+    std::ofstream file;
+    const unsigned width;
+    const unsigned height;
+    std::vector<std::uint8_t> planes;       // Y, then U and V at half resolution
+};
+
+} // namespace GL
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "../config.hpp"
+#include "../img/image.hpp"
+#include "atlas.hpp"
+
+#include <array>
+#include <cctype>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace GL {
+
+// Built-in 5x7 font, one row of 5 bits per line (most significant bit on the left). The glyphs
+// are rasterized once into a sheet of the sprite atlas, a glyph being a tile of its region (the
+// atlas pads every tile, so the mip levels of a glyph do not bleed into its neighbours).
+constexpr std::string_view GLYPH_CHARS = " 0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ-.:%";
+constexpr unsigned GLYPH_COLUMNS       = 5;
+constexpr unsigned GLYPH_ROWS          = 7;
+
+constexpr std::array<std::array<std::uint8_t, GLYPH_ROWS>, GLYPH_CHARS.size()> GLYPH_BITS { {
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },   // space
+    { 0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E },   // 0
+    { 0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E },
+    { 0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F },
+    { 0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E },
+    { 0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02 },
+    { 0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E },
+    { 0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E },
+    { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08 },
+    { 0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E },
+    { 0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C },   // 9
+    { 0x0E, 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11 },   // A
+    { 0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E },
+    { 0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E },
+    { 0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C },
+    { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F },
+    { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10 },
+    { 0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F },
+    { 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 },
+    { 0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E },
+    { 0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C },
+    { 0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11 },
+    { 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F },
+    { 0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11 },
+    { 0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11 },
+    { 0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E },
+    { 0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10 },
+    { 0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D },
+    { 0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11 },
+    { 0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E },
+    { 0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 },
+    { 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E },
+    { 0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04 },
+    { 0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A },
+    { 0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11 },
+    { 0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04 },
+    { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F },   // Z
+    { 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00 },   // -
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C },   // .
+    { 0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00 },   // :
+    { 0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03 },   // %
+} };
+
+inline const AtlasRegion* glyph_sheet = nullptr;
+
+// index of the glyph drawing the character (a space if the font does not have it)
+inline std::uint8_t glyph_index(const char c)
+{
+    const auto pos = GLYPH_CHARS.find(static_cast<char>(std::toupper(static_cast<unsigned char>(c))));
+    return pos == std::string_view::npos ? 0 : static_cast<std::uint8_t>(pos);
+}
+
+// rasterize the font (white on transparent) into the atlas
+inline void register_glyphs()
+{
+    constexpr unsigned width = GLYPH_COLUMNS * GLYPH_CHARS.size();
+    std::vector<unsigned char> pixels(width * GLYPH_ROWS * 4, 255);
+    for (unsigned glyph = 0; glyph < GLYPH_CHARS.size(); glyph++) {
+        for (unsigned row = 0; row < GLYPH_ROWS; row++) {
+            for (unsigned col = 0; col < GLYPH_COLUMNS; col++) {
+                const bool lit = (GLYPH_BITS[glyph][row] >> (GLYPH_COLUMNS - 1 - col)) & 1;
+                pixels[(row * width + glyph * GLYPH_COLUMNS + col) * 4 + 3] = lit ? 255 : 0;
+            }
+        }
+    }
+    glyph_sheet = &atlas.add(std::make_unique<const img::Image>(width, GLYPH_ROWS, pixels), GLYPH_CHARS.size());
+}
+
+} // namespace GL
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "../config.hpp"
+#include "../geometry.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace GL {
+
+// Time spent by the aircraft in each cell of a HEATMAP_DIM x HEATMAP_DIM grid over the screen plane,
+// fading with the time constant HEATMAP_DECAY_TIME. The decay is folded in a growing scale applied to
+// the new samples, so a tick costs O(aircraft) and the cells are only rewritten when the scale
+// has to be renormalized. A tick calls decay() once, then add() for each aircraft.
+class Heatmap
+{
+public:
+    Heatmap() : cells(HEATMAP_DIM * HEATMAP_DIM, 0.f) {}
+
+    void clear()
+    {
+        std::fill(cells.begin(), cells.end(), 0.f);
+        scale = 1.f;
+        version++;
+    }
+
+    void decay(const double dt)
+    {
+        version++;                                          // The samples of the tick follow
+        scale *= static_cast<float>(std::exp(dt / HEATMAP_DECAY_TIME));
+        if (scale < HEATMAP_MAX_SCALE) return;
+        for (auto& cell : cells) cell /= scale;
+        scale = 1.f;
+    }
+
+    void add(const Point2D& pos, const double weight)
+    {
+        const auto index = [](const float coordinate) {
+            return (coordinate / HEATMAP_EXTENT + 1.f) * .5f * HEATMAP_DIM;
+        };
+        const float column = index(pos.x()), row = index(pos.y());
+        if (column < 0 || row < 0 || column >= HEATMAP_DIM || row >= HEATMAP_DIM) return;
+        cells[static_cast<size_t>(row) * HEATMAP_DIM + static_cast<size_t>(column)] += static_cast<float>(weight) * scale;
+    }
+
+    // intensities relative to the hottest cell (the scale cancels out)
+    void rasterize(std::vector<std::uint8_t>& out) const
+    {
+        const float hottest = *std::max_element(cells.begin(), cells.end());
+        out.resize(cells.size());
+        std::transform(cells.begin(), cells.end(), out.begin(), [hottest](float cell) {
+            return static_cast<std::uint8_t>(hottest > 0 ? 255.f * cell / hottest : 0.f);
+        });
+    }
+
+    // increases once per tick and when the map is cleared
+    [[nodiscard]] unsigned long get_version() const { return version; }
+
+private:
+    std::vector<float> cells;
+    float scale           = 1.f;
+    unsigned long version = 0;
+};
+
+// simulation thread only: toggled by a keystroke (see toggle_heatmap)
+inline bool heatmap_enabled = false;
+inline Heatmap heatmap;
+
+} // namespace GL
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "../config.hpp"
+#include "../geometry.hpp"
+#include "glyphs.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+namespace GL {
+
+// spacing of the characters and of the lines of a label, in pixels
+constexpr float LABEL_ADVANCE     = (GLYPH_COLUMNS + 1) * LABEL_GLYPH_SCALE;
+constexpr float LABEL_LINE_HEIGHT = (GLYPH_ROWS + 1) * LABEL_GLYPH_SCALE;
+
+static_assert(LABEL_LINE_LENGTH * LABEL_ADVANCE <= LABEL_CELL_WIDTH && 2 * LABEL_LINE_HEIGHT <= LABEL_CELL_HEIGHT,
+              "a label must not span more than 2x2 cells of the placer");
+
+// Declutters the labels of a snapshot: a label is accepted if it overlaps none of the labels
+// accepted before it, and at most MAX_LABELS are accepted. The accepted rectangles are hashed in
+// a grid of LABEL_GRID_DIM x LABEL_GRID_DIM cells (coordinates wrapping around), each no smaller
+// than a label, so a test only looks at the labels of the 4 cells the rectangle touches.
+class LabelPlacer
+{
+public:
+    LabelPlacer() : cells(LABEL_GRID_DIM * LABEL_GRID_DIM) {}
+
+    void clear()
+    {
+        for (auto& cell : cells) cell.clear();
+        accepted = 0;
+    }
+
+    // [min, max] is the rectangle of the label in window pixels, return whether it can be drawn
+    bool reserve(const Point2D& min, const Point2D& max)
+    {
+        if (accepted >= MAX_LABELS) return false;
+        const Rect rect { min, max };
+        const auto keys = cells_of(rect);
+        for (const auto key : keys) {
+            for (const auto& other : cells[key]) {
+                if (rect.overlaps(other)) return false;
+            }
+        }
+        for (size_t i = 0; i < keys.size(); i++) {
+            if (std::find(keys.begin(), keys.begin() + i, keys[i]) == keys.begin() + i) cells[keys[i]].push_back(rect);
+        }
+        accepted++;
+        return true;
+    }
+
+private:
+    struct Rect
+    {
+        Point2D min, max;
+        [[nodiscard]] bool overlaps(const Rect& other) const
+        {
+            return min.x() < other.max.x() && other.min.x() < max.x() && min.y() < other.max.y() &&
+                   other.min.y() < max.y();
+        }
+    };
+
+    std::vector<std::vector<Rect>> cells;
+    unsigned accepted = 0;
+
+    static unsigned wrap(const float coordinate, const float size)
+    {
+        const auto cell = static_cast<long>(std::floor(coordinate / size));
+        return static_cast<unsigned>(((cell % LABEL_GRID_DIM) + LABEL_GRID_DIM) % LABEL_GRID_DIM);
+    }
+
+    static std::array<unsigned, 4> cells_of(const Rect& rect)
+    {
+        const unsigned x0 = wrap(rect.min.x(), LABEL_CELL_WIDTH), x1 = wrap(rect.max.x(), LABEL_CELL_WIDTH);
+        const unsigned y0 = wrap(rect.min.y(), LABEL_CELL_HEIGHT), y1 = wrap(rect.max.y(), LABEL_CELL_HEIGHT);
+        return { y0 * LABEL_GRID_DIM + x0, y0 * LABEL_GRID_DIM + x1, y1 * LABEL_GRID_DIM + x0, y1 * LABEL_GRID_DIM + x1 };
+    }
+};
+
+// simulation thread only: toggled by a keystroke
+inline bool labels_enabled = false;
+
+} // namespace GL
@@ -0,0 +1,61 @@
+#include "offscreen_context.hpp"
+
+#include <EGL/eglext.h>
+#include <GL/gl.h>
+#include <stdexcept>
+#include <string>
+
+namespace GL {
+
+namespace {
+
+[[noreturn]] void egl_error(const std::string& prefix)
+{
+    throw std::runtime_error { prefix + ": EGL error " + std::to_string(eglGetError()) };
+}
+
+} // namespace
+
+OffscreenContext::OffscreenContext(const unsigned width, const unsigned height)
+{
+    const auto get_display =
+            reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    if (get_display == nullptr) throw std::runtime_error { "EGL cannot select a platform" };
+    display = get_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    EGLint major = 0, minor = 0;
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor)) egl_error("Cannot open the surfaceless display");
+    if (!eglBindAPI(EGL_OPENGL_API)) egl_error("Cannot use desktop OpenGL");
+
+    const EGLint config_attributes[] = { EGL_SURFACE_TYPE, EGL_PBUFFER_BIT, EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+                                         EGL_RED_SIZE,     8,               EGL_GREEN_SIZE,      8,
+                                         EGL_BLUE_SIZE,    8,               EGL_ALPHA_SIZE,      8,
+                                         EGL_NONE };
+    EGLConfig config {};
+    EGLint configs = 0;
+    if (!eglChooseConfig(display, config_attributes, &config, 1, &configs) || configs == 0) {
+        egl_error("No pbuffer configuration");
+    }
+    const EGLint surface_attributes[] = { EGL_WIDTH, static_cast<EGLint>(width), EGL_HEIGHT, static_cast<EGLint>(height),
+                                          EGL_NONE };
+    surface = eglCreatePbufferSurface(display, config, surface_attributes);
+    if (surface == EGL_NO_SURFACE) egl_error("Cannot create the pbuffer");
+    context = eglCreateContext(display, config, EGL_NO_CONTEXT, nullptr);       // Compatibility profile
+    if (context == EGL_NO_CONTEXT) egl_error("Cannot create the context");
+    if (!eglMakeCurrent(display, surface, surface, context)) egl_error("Cannot make the context current");
+    glViewport(0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height));
+}
+
+OffscreenContext::~OffscreenContext()
+{
+    eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (context != EGL_NO_CONTEXT) eglDestroyContext(display, context);
+    if (surface != EGL_NO_SURFACE) eglDestroySurface(display, surface);
+    eglTerminate(display);
+}
+
+const char* OffscreenContext::renderer() const
+{
+    return reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+}
+
+} // namespace GL
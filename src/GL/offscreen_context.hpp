@@ -0,0 +1,27 @@
+#pragma once
+
+#include <EGL/egl.h>
+
+namespace GL {
+
+// Desktop OpenGL (compatibility profile) context drawing into a pbuffer, without any window
+// system: EGL on Mesa's surfaceless platform, rendered by the CPU driver on machines without GPU.
+// Made current by the constructor, which throws if the platform is not available.
+class OffscreenContext
+{
+public:
+    OffscreenContext(unsigned width, unsigned height);
+    OffscreenContext(const OffscreenContext&) = delete;
+    OffscreenContext& operator=(const OffscreenContext&) = delete;
+    ~OffscreenContext();
+
+    // name of the driver, as given by GL_RENDERER
+    [[nodiscard]] const char* renderer() const;
+
+private:
+    EGLDisplay display = EGL_NO_DISPLAY;
+    EGLSurface surface = EGL_NO_SURFACE;
+    EGLContext context = EGL_NO_CONTEXT;
+};
+
+} // namespace GL
@@ -1,8 +1,184 @@
 #include "opengl_interface.hpp"
+#include "../allocation.hpp"
 #include "../tower_sim.hpp"
+#include "frame_pacing.hpp"
+#include "heatmap.hpp"
+#include "atlas.hpp"
+
+#include <condition_variable>
+#include <thread>
 
 namespace GL {
 
+namespace {
+
+std::atomic<bool> simulating = false;
+std::mutex keys_mutex;
+std::vector<unsigned char> pending_keys;        // filled by the GLUT thread
+std::vector<unsigned char> running_keys;        // swapped with pending_keys by the simulation thread
+unsigned long ticks = 0;
+Snapshot::Clock::time_point last_publish = Snapshot::Clock::now();
+RateMeter tick_rate;
+RateMeter frame_rate;
+std::atomic<unsigned long> skipped_snapshots = 0;
+Pacer frame_pacer { DISPLAY_FRAMES_PER_SEC, MAX_PACING_LAG };
+std::vector<const Displayable*> visible;        // scratch of publish_snapshot
+PacingClock::time_point previous_frame = PacingClock::now();
+unsigned long published_snapshots = 0;
+unsigned long next_heat_snapshot  = 0;          // first snapshot that may rasterize the heatmap again
+
+// simulation thread: run the keystrokes received since the last tick
+void run_pending_keys()
+{
+    {
+        const std::lock_guard<std::mutex> lock { keys_mutex };
+        std::swap(pending_keys, running_keys);
+    }
+    for (const auto key : running_keys)
+    {
+        const auto iter = keystrokes.find(key);
+        if (iter != keystrokes.end())
+        {
+            (iter->second)();
+        }
+    }
+    running_keys.clear();
+}
+
+// The simulated time follows the real time elapsed between two ticks (times the framerate modifier),
+// so it stays aligned with the requested time scale even when ticks are late. Under overload the
+// snapshots are skipped first (at most MAX_SKIPPED_SNAPSHOTS in a row), never the ticks.
+void simulate()
+{
+    Pacer pacer { DEFAULT_TICKS_PER_SEC, MAX_PACING_LAG };
+    auto previous     = PacingClock::now();
+    unsigned skipped  = 0;
+    while (simulating)
+    {
+        run_pending_keys();
+        pacer.set_rate(ticks_per_sec != 0 ? ticks_per_sec : DEFAULT_TICKS_PER_SEC);
+        const auto start = PacingClock::now();
+        if (ticks_per_sec != 0) {
+            const double dt = framerate_modifier * std::chrono::duration<double, std::milli>(start - previous).count();
+            if (dt > 0) GL::step(dt);
+            tick_rate.add(start);
+        }
+        previous = start;
+        if (!pacer.is_late(PacingClock::now()) || skipped >= MAX_SKIPPED_SNAPSHOTS) {
+            publish_snapshot();
+            skipped = 0;
+        } else {
+            skipped++;
+            skipped_snapshots++;
+        }
+        pacer.wait();
+    }
+}
+
+// GLUT thread, inside glBegin(GL_QUADS)
+void draw_sprite(const Sprite& sprite, const float alpha)
+{
+    const Point2D pos                = sprite.position(alpha);
+    const Point2D half               = sprite.dim * 0.5f;
+    const auto [left, top, right, bottom] = sprite.region->tile_uv(sprite.tile_at(alpha));
+    glTexCoord2f(left, top);
+    glVertex2f(pos.x() - half.x(), pos.y() + half.y());
+    glTexCoord2f(right, top);
+    glVertex2f(pos.x() + half.x(), pos.y() + half.y());
+    glTexCoord2f(right, bottom);
+    glVertex2f(pos.x() + half.x(), pos.y() - half.y());
+    glTexCoord2f(left, bottom);
+    glVertex2f(pos.x() - half.x(), pos.y() - half.y());
+}
+
+// GLUT thread: the heat texture is uploaded only when the snapshot brings a newer version (the other
+// slots of the buffer may still hold older ones)
+void draw_heatmap(const Snapshot& frame)
+{
+    static GLuint heat_texture            = 0;
+    static unsigned long uploaded_version = 0;
+    if (frame.heat.size() != HEATMAP_DIM * HEATMAP_DIM) return;
+    if (heat_texture == 0)
+    {
+        glGenTextures(1, &heat_texture);
+        glBindTexture(GL_TEXTURE_2D, heat_texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, HEATMAP_DIM, HEATMAP_DIM, 0, GL_ALPHA, GL_UNSIGNED_BYTE, nullptr);
+        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        uploaded_version = 0;
+    }
+    glBindTexture(GL_TEXTURE_2D, heat_texture);
+    if (frame.heat_version > uploaded_version)
+    {
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, HEATMAP_DIM, HEATMAP_DIM, GL_ALPHA, GL_UNSIGNED_BYTE, frame.heat.data());
+        uploaded_version = frame.heat_version;
+    }
+    glColor4f(1.f, .3f, 0.f, HEATMAP_ALPHA);
+    glBegin(GL_QUADS);
+    glTexCoord2f(0.f, 0.f);
+    glVertex2f(-HEATMAP_EXTENT, -HEATMAP_EXTENT);
+    glTexCoord2f(1.f, 0.f);
+    glVertex2f(HEATMAP_EXTENT, -HEATMAP_EXTENT);
+    glTexCoord2f(1.f, 1.f);
+    glVertex2f(HEATMAP_EXTENT, HEATMAP_EXTENT);
+    glTexCoord2f(0.f, 1.f);
+    glVertex2f(-HEATMAP_EXTENT, HEATMAP_EXTENT);
+    glEnd();
+    handle_error("Cannot display the heatmap");
+}
+
+void refresh(const int frame)
+{
+    glutPostRedisplay();
+    const auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(frame_pacer.advance());
+    glutTimerFunc(static_cast<unsigned>(delay.count()), refresh, frame + 1);
+}
+
+} // namespace
+
+// simulation thread: record the visible displayables, back to front, and hand them to the render thread
+void publish_snapshot()
+{
+    const alloc::PhaseGuard phase { alloc::Phase::display };
+    const auto start      = PacingClock::now();
+    const auto [min, max] = camera.view(CULL_MARGIN);
+    visible.clear();
+    display_grid.collect(min, max, visible);
+    // sort the displayable by their z-coordinate
+    std::sort(visible.begin(), visible.end(), disp_z_cmp {});
+    const auto sorted = PacingClock::now();
+    Snapshot& frame = snapshots.back();
+    frame.sprites.clear();
+    frame.trail_segments.clear();
+    frame.labels.clear();
+    frame.pixel = camera.pixel_size();
+    frame.heat_shown = heatmap_enabled;
+    frame.tick      = ticks;
+    frame.sequence  = ++published_snapshots;
+    if (heatmap_enabled && frame.heat_version != heatmap.get_version() && frame.sequence >= next_heat_snapshot) {
+        heatmap.rasterize(frame.heat);                          // At most every HEATMAP_UPLOAD_PERIOD snapshots
+        frame.heat_version = heatmap.get_version();
+        next_heat_snapshot = frame.sequence + HEATMAP_UPLOAD_PERIOD;
+    }
+    frame.published = Snapshot::Clock::now();
+    frame.period    = std::chrono::duration<float>(frame.published - last_publish).count();
+    last_publish    = frame.published;
+    for (const auto& item : visible)
+    {
+        item->display(frame);
+    }
+    perf_sample.stage_ms[static_cast<size_t>(Stage::sort)] = std::chrono::duration<float, std::milli>(sorted - start).count();
+    perf_sample.stage_ms[static_cast<size_t>(Stage::snapshot)] =
+            std::chrono::duration<float, std::milli>(PacingClock::now() - sorted).count();
+    perf_sample.tick_rate   = static_cast<float>(tick_rate.rate());
+    perf_sample.target_rate = ticks_per_sec;
+    if (perf_hud.is_shown() && sample_world) sample_world(perf_sample);
+    frame.perf  = perf_sample;
+    perf_sample = {};                                           // The tick stages of the next snapshot start at 0
+    snapshots.publish();
+}
+
 void handle_error(const std::string& prefix, const GLenum err)
 {
     if (err != GL_NO_ERROR)
@@ -14,11 +190,14 @@ void handle_error(const std::string& prefix, const GLenum err)
 
 void keyboard(unsigned char key, int, int)
 {
-    const auto iter = keystrokes.find(key);
-    if (iter != keystrokes.end())
+    const auto iter = ui_keystrokes.find(key);
+    if (iter != ui_keystrokes.end())
     {
         (iter->second)();
+        return;
     }
+    const std::lock_guard<std::mutex> lock { keys_mutex };
+    pending_keys.emplace_back(key);
 }
 
 void toggle_fullscreen()
@@ -37,13 +216,28 @@ void toggle_fullscreen()
     fullscreen = !fullscreen;
 }
 
+void special_keyboard(int key, int, int)
+{
+    switch (key)
+    {
+        case GLUT_KEY_LEFT: camera.pan(-1.f, 0.f); break;
+        case GLUT_KEY_RIGHT: camera.pan(1.f, 0.f); break;
+        case GLUT_KEY_UP: camera.pan(0.f, 1.f); break;
+        case GLUT_KEY_DOWN: camera.pan(0.f, -1.f); break;
+        default: break;
+    }
+}
+
 void change_zoom(float factor)
 {
-    zoom *= factor;
-    glMatrixMode(GL_PROJECTION);
-    glLoadIdentity();
-    glOrtho(-zoom, zoom, -zoom, zoom, 0.0f, 1.0f); // left, right, bottom, top, near, far
-    handle_error("Zoom");
+    camera.change_zoom(factor);
+}
+void toggle_heatmap()
+{
+    heatmap_enabled = !heatmap_enabled;
+    if (!heatmap_enabled) return;
+    heatmap.clear();                                            // Only the traffic seen since
+    next_heat_snapshot = 0;                                     // Not the texture of the last time it was shown
 }
 void change_framerate(int amount) {
     if (old_framerate != 0) {
@@ -55,69 +249,99 @@ void change_framerate(int amount) {
     }
 }
 void change_framerate_modifier(double delta) {
-    if (framerate_modifier <= 5 && framerate_modifier > 0) {
-        framerate_modifier *= delta;
-    }
+    framerate_modifier = std::clamp(framerate_modifier * delta, DEFAULT_FRAMERATE_MODIFIER / MAX_TIME_SCALE,
+                                    DEFAULT_FRAMERATE_MODIFIER * MAX_TIME_SCALE);
 }
 
 void reshape_window(int w, int h)
 {
     glViewport(0, 0, w, h);
-    glMatrixMode(GL_PROJECTION);
-    glLoadIdentity();
-    glOrtho(-zoom, zoom, -zoom, zoom, 0.0f, 1.0f); // left, right, bottom, top, near, far
+    camera.resize(w, h);
+    camera.apply();
     handle_error("Cannot reshape window");
 }
 
-void display()
+void draw_frame(const Snapshot& frame, const float alpha)
 {
-    // sort the displayable by their z-coordinate
-    std::sort(display_queue.begin(), display_queue.end(), disp_z_cmp {});
-    glMatrixMode(GL_PROJECTION);
-    glLoadIdentity();
-    glOrtho(-zoom, zoom, -zoom, zoom, 0.0f, 1.0f); // left, right, bottom, top, near, far
+    camera.apply();
     glClear(GL_COLOR_BUFFER_BIT);
+    if (!frame.trail_segments.empty())
+    {
+        glColor4f(1.f, 1.f, 1.f, TRAIL_ALPHA);
+        glBegin(GL_LINES);
+        for (const auto& point : frame.trail_segments) glVertex2fv(point.values.data());
+        glEnd();
+    }
     glEnable(GL_TEXTURE_2D);
-    for (const auto& item : display_queue)
+    atlas.bind();                                                   // Every sprite is in the atlas: one batch
+    glColor3f(1, 1, 1);
+    glBegin(GL_QUADS);
+    for (const auto& sprite : frame.sprites)
     {
-        item->display();
+        draw_sprite(sprite, alpha);
     }
+    glEnd();
+    handle_error("Cannot display the sprites");
+    if (frame.heat_shown) draw_heatmap(frame);
     glDisable(GL_TEXTURE_2D);
+}
+
+void display()
+{
+    const alloc::PhaseGuard phase { alloc::Phase::display };
+    const auto start      = PacingClock::now();
+    const Snapshot& frame = snapshots.latest();
+    draw_frame(frame, frame.interpolation(Snapshot::Clock::now()));
+    perf_hud.draw(frame);
+    const auto drawn = PacingClock::now();
+    perf_hud.record(frame, std::chrono::duration<float, std::milli>(start - previous_frame).count(),
+                    std::chrono::duration<float, std::milli>(drawn - start).count());
+    previous_frame = start;
     glutSwapBuffers();
+    frame_rate.add(PacingClock::now());
 }
 
-void timer(const int step)
+void step(const double dt)
 {
-    if (ticks_per_sec != 0) {
-        const double dt = framerate_modifier * std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - oldTime).count();
-        for (const auto& dynamic : move_queue) {
-            dynamic->move(dt);
-        }
-        glutPostRedisplay();
-        oldTime = std::chrono::system_clock::now();
-        glutTimerFunc(1000u / ticks_per_sec, timer, step + 1);
-    } else {
-        oldTime = std::chrono::system_clock::now();
-        glutTimerFunc(0, timer, step + 1);
-    }
+    alloc::begin_tick();
+    move_queue.move(dt);
+    alloc::end_tick();
+    ticks++;
+    perf_sample.ticks++;
 }
-void init_gl(int argc, char** argv, const char* title)
+
+void advance(const double dt)
+{
+    alloc::begin_tick();
+    move_queue.move_all(dt);
+    alloc::end_tick();
+    perf_sample.ticks++;
+}
+
+void init_gl_state()
 {
-    glutInit(&argc, argv);
-    glutInitDisplayMode(GLUT_RGBA);
-    glutInitWindowSize(DEFAULT_WINDOW_WIDTH, DEFAULT_WINDOW_HEIGHT);
-    glutCreateWindow(title);
-    // glutFullScreen();
     glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
     // glEnable(GL_DEPTH_TEST);
     // The following two lines enable semi transparent
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     glShadeModel(GL_FLAT);
+}
+
+void init_gl(int argc, char** argv, const char* title)
+{
+    glutInit(&argc, argv);
+    glutInitDisplayMode(GLUT_RGBA);
+    glutInitWindowSize(DEFAULT_WINDOW_WIDTH, DEFAULT_WINDOW_HEIGHT);
+    glutCreateWindow(title);
+    // glutFullScreen();
+    init_gl_state();
 
     glutKeyboardFunc(keyboard);
+    glutSpecialFunc(special_keyboard);
     glutDisplayFunc(display);
     glutReshapeFunc(reshape_window);
+    glutSetOption(GLUT_ACTION_ON_WINDOW_CLOSE, GLUT_ACTION_GLUTMAINLOOP_RETURNS);   // To join the simulation
 
     handle_error("Cannot init OpenGL");
 }
@@ -126,14 +350,60 @@ void pause() {
     auto new_framerate = old_framerate;
     old_framerate = ticks_per_sec;
     ticks_per_sec = new_framerate;
-    oldTime = std::chrono::system_clock::now();
+}
+
+void display_rates()
+{
+    std::cout << "Simulation: " << tick_rate.rate() << " ticks/s (target " << ticks_per_sec << ") | Display: "
+              << frame_rate.rate() << " frames/s (target " << DISPLAY_FRAMES_PER_SEC << ") | Skipped snapshots: "
+              << skipped_snapshots << std::endl;
 }
 
 void loop()
 {
-    oldTime = std::chrono::system_clock::now();
-    glutTimerFunc(100, timer, 0);
+    const alloc::PhaseGuard phase { alloc::Phase::display };     // Everything on this thread is rendering
+    simulating = true;
+    std::thread simulation { simulate };
+    glutTimerFunc(0, refresh, 0);
     glutMainLoop();
+    simulating = false;
+    simulation.join();
+}
+
+void run_headless(const unsigned long count, const unsigned every, const std::function<void(const Snapshot&)>& capture)
+{
+    assert(every > 0 && ticks_per_sec > 0);
+    std::mutex mutex;                       // guards the publication and the pick up of the snapshots, and done
+    std::condition_variable changed;        // a snapshot was published or picked up, or the run is over
+    bool done = false;
+    std::thread capturing { [&capture, &mutex, &changed, &done]() {
+        const alloc::PhaseGuard phase { alloc::Phase::display };
+        while (true) {
+            std::unique_lock<std::mutex> lock { mutex };
+            changed.wait(lock, [&done]() { return done || snapshots.has_unread(); });
+            if (!snapshots.has_unread()) return;                // The last snapshot is published before done
+            const Snapshot& frame = snapshots.latest();
+            lock.unlock();
+            changed.notify_one();                               // The next snapshot can be filled meanwhile
+            capture(frame);
+        }
+    } };
+    const double dt = framerate_modifier * 1000. / ticks_per_sec;
+    for (unsigned long tick = 1; tick <= count; tick++) {
+        step(dt);
+        if (tick % every != 0) continue;
+        std::unique_lock<std::mutex> lock { mutex };
+        changed.wait(lock, []() { return !snapshots.has_unread(); });  // Only waits when the capture is a snapshot behind
+        publish_snapshot();
+        lock.unlock();
+        changed.notify_one();
+    }
+    {
+        const std::lock_guard<std::mutex> lock { mutex };
+        done = true;
+    }
+    changed.notify_one();
+    capturing.join();
 }
 
 void exit_loop()
@@ -2,14 +2,19 @@
 
 #include "../config.hpp"
 #include "../geometry.hpp"
+#include "camera.hpp"
 #include "displayable.hpp"
 #include "dynamic_object.hpp"
+#include "snapshot.hpp"
 
 #include <GL/freeglut.h>
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <unordered_map>
@@ -19,25 +24,46 @@
 
 namespace GL {
 inline unsigned int ticks_per_sec = DEFAULT_TICKS_PER_SEC;
-inline float zoom                 = DEFAULT_ZOOM;
 inline bool fullscreen            = false;
 inline unsigned int old_framerate = 0;
-inline std::chrono::time_point<std::chrono::system_clock> oldTime{};
-inline double framerate_modifier  = 0.0167;
+inline double framerate_modifier  = DEFAULT_FRAMERATE_MODIFIER;
 
 using KeyStroke = std::function<void(void)>;
 
+// The simulation runs on its own thread and publishes a snapshot after every tick, the GLUT
+// thread only draws the latest one. ui_keystrokes act on the window and run on the GLUT thread,
+// keystrokes act on the simulation and are queued until the start of the next tick.
 inline std::unordered_map<char, KeyStroke> keystrokes;
+inline std::unordered_map<char, KeyStroke> ui_keystrokes;
 
 void handle_error(const std::string& prefix, const GLenum err = glGetError());
 void keyboard(unsigned char key, int, int);
+// arrow keys: pan the camera
+void special_keyboard(int key, int, int);
 void toggle_fullscreen();
 void change_zoom(float factor);
+// simulation thread: show or hide the heatmap, which starts empty when shown
+void toggle_heatmap();
 void change_framerate(int amount);
 void change_framerate_modifier(double delta);
 void init_gl(int argc, char** argv, const char* title);
+// blending and clear color, for the GLUT window or any other current context
+void init_gl_state();
 void pause();
+// achieved simulation and display rates
+void display_rates();
+// simulation thread: one tick
+void step(double dt);
+// simulation thread: cull and sort the display grid, then publish what is visible as the next snapshot
+void publish_snapshot();
+// draw a snapshot in the current context (everything but the HUD), `alpha` between its previous and current positions
+void draw_frame(const Snapshot& frame, float alpha);
+// move every dynamic object by dt at once, whatever its update period
+void advance(double dt);
 void loop();
+// headless run without GLUT: `count` ticks at the nominal tick length and as fast as possible, every
+// `every` ticks a snapshot is handed to `capture` on its own thread, in parallel with the next ticks
+void run_headless(unsigned long count, unsigned every, const std::function<void(const Snapshot&)>& capture);
 void exit_loop();
 
 } // namespace GL
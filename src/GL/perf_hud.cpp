@@ -0,0 +1,127 @@
+#include "perf_hud.hpp"
+
+#include "atlas.hpp"
+#include "glyphs.hpp"
+#include "opengl_interface.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+namespace GL {
+
+namespace {
+
+constexpr float HUD_MARGIN    = 8.f;
+constexpr float ADVANCE       = (GLYPH_COLUMNS + 1) * HUD_GLYPH_SCALE;
+constexpr float LINE_HEIGHT   = (GLYPH_ROWS + 3) * HUD_GLYPH_SCALE;
+constexpr unsigned TEXT_WIDTH = 20;                         // characters before the graph of the line
+constexpr float GRAPH_WIDTH   = 1.5f * HUD_HISTORY;
+
+// inside glBegin(GL_QUADS), (x, y) is the top-left corner of the text
+void draw_text(const char* text, float x, const float y)
+{
+    for (; *text != '\0'; text++, x += ADVANCE) {
+        const auto glyph = glyph_index(*text);
+        if (glyph == 0) continue;
+        const auto [left, top, right, bottom] = glyph_sheet->tile_uv(glyph);
+        const float w = GLYPH_COLUMNS * HUD_GLYPH_SCALE, h = GLYPH_ROWS * HUD_GLYPH_SCALE;
+        glTexCoord2f(left, top);
+        glVertex2f(x, y);
+        glTexCoord2f(right, top);
+        glVertex2f(x + w, y);
+        glTexCoord2f(right, bottom);
+        glVertex2f(x + w, y - h);
+        glTexCoord2f(left, bottom);
+        glVertex2f(x, y - h);
+    }
+}
+
+} // namespace
+
+void PerfHud::push(History& values, const float value)
+{
+    if (values.size() == values.capacity()) values.pop_front();
+    values.push_back(value);
+}
+
+void PerfHud::record(const Snapshot& frame, const float frame_ms, const float draw_ms)
+{
+    push(history[frame_time], frame_ms);
+    push(history[draw_time], draw_ms);
+    if (frame.sequence == recorded_sequence) return;       // Drawn again while the simulation lags
+    recorded_sequence = frame.sequence;
+    for (size_t stage = 0; stage < STAGE_COUNT; stage++) push(history[stage], frame.perf.stage_time(static_cast<Stage>(stage)));
+    push(history[tick_rate], frame.perf.tick_rate);
+}
+
+void PerfHud::draw(const Snapshot& frame) const
+{
+    if (!shown) return;
+    const PerfSample& sample = frame.perf;
+    std::array<std::array<char, 32>, series_count + 2> lines {};
+    std::snprintf(lines[0].data(), lines[0].size(), "FLEET %zu HOLD %zu", sample.fleet, sample.circling);
+    std::snprintf(lines[1].data(), lines[1].size(), "FREE TERMINALS %zu", sample.free_terminals);
+    for (size_t series = 0; series < series_count; series++) {
+        const float last = history[series].empty() ? 0.f : history[series].back();
+        if (series == tick_rate) {
+            std::snprintf(lines[series + 2].data(), lines[series + 2].size(), "TICKS %.0f OF %u", last, sample.target_rate);
+        } else {
+            std::snprintf(lines[series + 2].data(), lines[series + 2].size(), "%-8s %6.2f MS", SERIES_NAMES[series].data(), last);
+        }
+    }
+
+    const float width = static_cast<float>(glutGet(GLUT_WINDOW_WIDTH));
+    const float height = static_cast<float>(glutGet(GLUT_WINDOW_HEIGHT));
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
+    glOrtho(0., width, 0., height, 0., 1.);                 // Window pixels, origin at the bottom-left
+    const float left = HUD_MARGIN, top = height - HUD_MARGIN;
+    const float right = left + TEXT_WIDTH * ADVANCE + GRAPH_WIDTH, bottom = top - lines.size() * LINE_HEIGHT;
+
+    glDisable(GL_TEXTURE_2D);
+    glColor4f(0.f, 0.f, 0.f, .6f);
+    glRectf(left - HUD_MARGIN / 2, bottom - HUD_MARGIN / 2, right + HUD_MARGIN / 2, top + HUD_MARGIN / 2);
+
+    glEnable(GL_TEXTURE_2D);
+    atlas.bind();
+    glColor3f(1.f, 1.f, 1.f);
+    glBegin(GL_QUADS);
+    for (size_t line = 0; line < lines.size(); line++) draw_text(lines[line].data(), left, top - line * LINE_HEIGHT);
+    glEnd();
+
+    // one sparkline per series, each scaled to its own maximum
+    glDisable(GL_TEXTURE_2D);
+    glColor3f(.3f, 1.f, .3f);
+    const float graph_left = left + TEXT_WIDTH * ADVANCE, graph_height = LINE_HEIGHT - 2 * HUD_GLYPH_SCALE;
+    for (size_t series = 0; series < series_count; series++) {
+        const History& values = history[series];
+        if (values.empty()) continue;
+        const float peak     = std::max(*std::max_element(values.begin(), values.end()), 1e-3f);
+        const float baseline = top - (series + 3) * LINE_HEIGHT + 2 * HUD_GLYPH_SCALE;
+        glBegin(GL_LINE_STRIP);
+        for (size_t i = 0; i < values.size(); i++) {
+            glVertex2f(graph_left + i * GRAPH_WIDTH / HUD_HISTORY, baseline + values[i] / peak * graph_height);
+        }
+        glEnd();
+    }
+    handle_error("Cannot display the performance HUD");     // Leaves the texturing off, as draw_frame()
+}
+
+void PerfHud::dump(const std::filesystem::path& path) const
+{
+    std::ofstream file { path };
+    for (size_t series = 0; series < series_count; series++) {
+        file << SERIES_NAMES[series];
+        for (const float value : history[series]) file << ',' << value;
+        file << '\n';
+    }
+    if (!file) {
+        std::cout << "Cannot write the performance history to " << path << std::endl;
+        return;
+    }
+    std::cout << "Performance history written to " << path << std::endl;
+}
+
+} // namespace GL
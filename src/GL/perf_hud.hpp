@@ -0,0 +1,95 @@
+#pragma once
+
+#include "../config.hpp"
+#include "../fixed_deque.hpp"
+#include "frame_pacing.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <string_view>
+
+namespace GL {
+
+// parts of a tick (traffic, aircraft and airport) and of the publication of a snapshot timed by the simulation thread
+enum class Stage { traffic, aircraft, airport, sort, snapshot, count };
+constexpr size_t STAGE_COUNT = static_cast<size_t>(Stage::count);
+
+// what the simulation thread measured for a snapshot
+struct PerfSample
+{
+    std::array<float, STAGE_COUNT> stage_ms {};     // the tick stages cover the ticks since the previous snapshot
+    unsigned ticks          = 0;                    // ticks since the previous snapshot
+    float tick_rate         = 0;
+    unsigned target_rate    = 0;
+    size_t fleet            = 0;
+    size_t circling         = 0;
+    size_t free_terminals   = 0;
+
+    // milliseconds spent in the stage per tick (tick stages) or per snapshot (the others)
+    [[nodiscard]] float stage_time(const Stage stage) const
+    {
+        const auto index = static_cast<size_t>(stage);
+        return stage < Stage::sort && ticks > 1 ? stage_ms[index] / ticks : stage_ms[index];
+    }
+};
+
+// simulation thread only: the sample being measured
+inline PerfSample perf_sample;
+// simulation thread: fills the world counters of the sample (set by the simulation, called while the HUD is shown)
+inline std::function<void(PerfSample&)> sample_world;
+
+// add the lifetime of the timer to a stage of the current sample
+class StageTimer
+{
+public:
+    explicit StageTimer(const Stage stage_) : stage { stage_ } {}
+    StageTimer(const StageTimer&) = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+    ~StageTimer()
+    {
+        perf_sample.stage_ms[static_cast<size_t>(stage)] +=
+                std::chrono::duration<float, std::milli>(PacingClock::now() - start).count();
+    }
+
+private:
+    const Stage stage;
+    const PacingClock::time_point start = PacingClock::now();
+};
+
+struct Snapshot;
+
+// GLUT thread only: on-screen statistics with the history of each measure in a ring buffer
+class PerfHud
+{
+public:
+    void toggle() { shown = !shown; }
+    // also read by the simulation thread, which samples the world only while the HUD is shown
+    [[nodiscard]] bool is_shown() const { return shown; }
+    // the simulation measures are recorded once per snapshot, the frame and draw times once per frame
+    void record(const Snapshot& frame, float frame_ms, float draw_ms);
+    // draw over the frame, in window coordinates
+    void draw(const Snapshot& frame) const;
+    // write each history as a line `name,oldest,...,newest`
+    void dump(const std::filesystem::path& path) const;
+
+private:
+    enum Series { traffic, aircraft, airport, sort, snapshot, tick_rate, frame_time, draw_time, series_count };
+    static constexpr std::array<std::string_view, series_count> SERIES_NAMES {
+        "TRAFFIC", "AIRCRAFT", "AIRPORT", "SORT", "SNAPSHOT", "TICKS", "FRAME", "DRAW"
+    };
+    using History = FixedDeque<float, HUD_HISTORY>;
+
+    std::array<History, series_count> history;
+    unsigned long recorded_sequence = 0;
+    std::atomic<bool> shown         = false;
+
+    static void push(History& values, float value);
+};
+
+inline PerfHud perf_hud;
+
+} // namespace GL
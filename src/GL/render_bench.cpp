@@ -0,0 +1,123 @@
+#include "render_bench.hpp"
+
+#include "../aircraft_sprites.hpp"
+#include "opengl_interface.hpp"
+#include "software_renderer.hpp"
+#ifdef HAS_OFFSCREEN_GL
+#include "offscreen_context.hpp"
+#endif
+
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <random>
+
+namespace GL {
+
+namespace {
+
+class SyntheticAircraft : public Displayable
+{
+public:
+    SyntheticAircraft(const AtlasRegion& region_, const Point2D& pos_, const unsigned tile_) :
+        Displayable { pos_.x() + pos_.y() }, region { region_ }, pos { pos_ }, tile { tile_ }
+    {
+        place(pos);
+    }
+
+    void display(Snapshot& frame) const override
+    {
+        frame.add_sprite(region, pos, { PLANE_TEXTURE_DIM, PLANE_TEXTURE_DIM }, tile);
+    }
+
+private:
+    const AtlasRegion& region;
+    const Point2D pos;
+    const unsigned tile;
+};
+
+struct FrameCost
+{
+    double sort = 0, submit = 0, driver = 0;
+    size_t sprites = 0;
+};
+
+double elapsed_ms(const PacingClock::time_point from, const PacingClock::time_point to)
+{
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+} // namespace
+
+void run_render_bench(const std::vector<size_t>& counts)
+{
+    assert(!aircraft_sprites.empty());
+    std::unique_ptr<SoftwareRenderer> software;
+#ifdef HAS_OFFSCREEN_GL
+    std::unique_ptr<OffscreenContext> context;
+    try {
+        context = std::make_unique<OffscreenContext>(DEFAULT_WINDOW_WIDTH, DEFAULT_WINDOW_HEIGHT);
+        init_gl_state();
+        atlas.build();
+        std::cout << "Renderer: OpenGL on " << context->renderer() << std::endl;
+    } catch (const std::runtime_error& e) {
+        std::cout << e.what() << std::endl;
+        context.reset();
+    }
+    if (!context)
+#endif
+    {
+        atlas.build(false);
+        software = std::make_unique<SoftwareRenderer>(atlas, DEFAULT_WINDOW_WIDTH, DEFAULT_WINDOW_HEIGHT);
+        std::cout << "Renderer: software" << std::endl;
+    }
+
+    std::printf("%10s %6s %8s %10s %10s %10s %10s\n", "aircraft", "zoom", "sprites", "sort ms", "submit ms", "driver ms",
+                "frame ms");
+    std::mt19937 engine { 0 };                                  // The same scenes from one run to the next
+    std::uniform_real_distribution<float> coordinate { -BENCH_EXTENT, BENCH_EXTENT };
+    std::uniform_int_distribution<unsigned> tile { 0, NUM_AIRCRAFT_TILES - 1 };
+    for (const size_t count : counts) {
+        std::deque<SyntheticAircraft> scene;
+        for (size_t i = 0; i < count; i++) {
+            const auto& sprite = *aircraft_sprites[i % aircraft_sprites.size()];
+            scene.emplace_back(sprite, Point2D { coordinate(engine), coordinate(engine) }, tile(engine));
+        }
+        for (const float zoom : BENCH_ZOOMS) {
+            camera.reset();
+            camera.change_zoom(zoom / DEFAULT_ZOOM);
+            FrameCost cost;
+            for (unsigned frame_number = 0; frame_number <= BENCH_FRAMES; frame_number++) {
+                publish_snapshot();
+                const Snapshot& frame = snapshots.latest();
+                const auto start      = PacingClock::now();
+                if (software) {
+                    software->render(frame, camera.view(0.f));
+                } else {
+                    draw_frame(frame, 1.f);
+                }
+                const auto submitted = PacingClock::now();
+                if (!software) glFinish();
+                const auto finished = PacingClock::now();
+                if (frame_number == 0) continue;                // Warm-up: caches, first upload, lazy driver work
+                cost.sort += frame.perf.stage_ms[static_cast<size_t>(Stage::sort)];
+                cost.submit += frame.perf.stage_ms[static_cast<size_t>(Stage::snapshot)];
+                if (software) {
+                    cost.driver += elapsed_ms(start, finished);
+                } else {
+                    cost.submit += elapsed_ms(start, submitted);
+                    cost.driver += elapsed_ms(submitted, finished);
+                }
+                cost.sprites = frame.sprites.size();
+            }
+            const double sort = cost.sort / BENCH_FRAMES, submit = cost.submit / BENCH_FRAMES,
+                         driver = cost.driver / BENCH_FRAMES;
+            std::printf("%10zu %6.2f %8zu %10.3f %10.3f %10.3f %10.3f\n", count, zoom, cost.sprites, sort, submit, driver,
+                        sort + submit + driver);
+        }
+    }
+}
+
+} // namespace GL
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace GL {
+
+// Cost of the render path alone, on synthetic aircraft spread uniformly over the screen plane.
+// For each aircraft count and each zoom level of BENCH_ZOOMS, BENCH_FRAMES snapshots are published
+// and drawn, and the mean frame time is reported split into:
+// - sort: culling the display grid and sorting the visible displayables,
+// - submit: filling the snapshot and issuing the draw calls,
+// - driver: waiting for the driver to finish the frame (glFinish).
+// The frames are drawn by the GL renderer in an offscreen context when the build has one, by the
+// software renderer otherwise (then `driver` is its rasterization time).
+// Must run before the atlas is built, once every sprite is registered.
+void run_render_bench(const std::vector<size_t>& counts);
+
+} // namespace GL
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "../geometry.hpp"
+#include "label_placer.hpp"
+#include "perf_hud.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace GL {
+
+struct AtlasRegion;
+
+// what the render thread needs to draw a sprite: where it was at the previous snapshot and where
+// it is now, so that the frames drawn between two ticks can be interpolated
+struct Sprite
+{
+    const AtlasRegion* region;
+    Point2D from;
+    Point2D to;
+    Point2D dim;
+    unsigned from_tile;
+    unsigned tile;
+
+    [[nodiscard]] Point2D position(const float alpha) const { return from + (to - from) * alpha; }
+    [[nodiscard]] unsigned tile_at(const float alpha) const { return alpha < .5f ? from_tile : tile; }
+};
+
+// everything drawn in a frame, back to front, as published by the simulation thread after a tick
+struct Snapshot
+{
+    using Clock = std::chrono::steady_clock;
+
+    std::vector<Sprite> sprites;
+    std::vector<Point2D> trail_segments;    // pairs of points, drawn below the sprites
+    bool heat_shown = false;
+    unsigned long heat_version = 0;         // the render thread uploads the heat only when it changes
+    std::vector<std::uint8_t> heat;         // HEATMAP_DIM x HEATMAP_DIM intensities, drawn over the sprites
+    unsigned long tick     = 0;
+    unsigned long sequence = 0;         // number of the snapshot, the previous one has sequence - 1
+    Clock::time_point published {};
+    float period = 0;                   // seconds since the previous snapshot
+    PerfSample perf;                    // shown by the performance HUD
+    Point2D pixel { 0.f, 0.f };         // size of a window pixel on screen, labels keep their size in pixels
+    LabelPlacer labels;                 // labels accepted so far, while the snapshot is filled
+
+    void add_sprite(const AtlasRegion& region, const Point2D& pos, const Point2D& dim, const unsigned tile = 0)
+    {
+        sprites.push_back({ &region, pos, pos, dim, tile, tile });
+    }
+    void add_moving_sprite(const AtlasRegion& region, const Point2D& from, const Point2D& to, const Point2D& dim,
+                           const unsigned from_tile, const unsigned tile)
+    {
+        sprites.push_back({ &region, from, to, dim, from_tile, tile });
+    }
+
+    // how far between the previous and this snapshot a frame drawn at `now` is (the display lags a tick behind)
+    [[nodiscard]] float interpolation(const Clock::time_point now) const
+    {
+        if (period <= 0) return 1.f;
+        return std::clamp(std::chrono::duration<float>(now - published).count() / period, 0.f, 1.f);
+    }
+};
+
+// Lock-free triple buffer: the simulation fills the back snapshot and publishes it, the render
+// thread picks up the latest published one. Neither side ever waits for the other, and the
+// snapshots keep their storage from one frame to the next.
+class SnapshotBuffer
+{
+public:
+    // simulation thread only
+    Snapshot& back() { return slots[back_idx]; }
+    void publish() { back_idx = ready.exchange(back_idx | FRESH, std::memory_order_acq_rel) & INDEX; }
+
+    // true until the render thread picks up the last published snapshot
+    [[nodiscard]] bool has_unread() const { return ready.load(std::memory_order_acquire) & FRESH; }
+
+    // render thread only
+    const Snapshot& latest()
+    {
+        if (ready.load(std::memory_order_relaxed) & FRESH) {
+            front_idx = ready.exchange(front_idx, std::memory_order_acq_rel) & INDEX;
+        }
+        return slots[front_idx];
+    }
+
+private:
+    static constexpr unsigned FRESH = 4;        // set on the ready index when it has not been read yet
+    static constexpr unsigned INDEX = 3;
+
+    std::array<Snapshot, 3> slots;
+    unsigned back_idx  = 0;
+    unsigned front_idx = 1;
+    std::atomic<unsigned> ready { 2 };
+};
+
+inline SnapshotBuffer snapshots;
+
+} // namespace GL
@@ -0,0 +1,82 @@
+#include "software_renderer.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace GL {
+
+namespace {
+
+// (x * y) / 255 rounded, exact for 8-bit operands and without a division
+inline std::uint32_t mul_255(const std::uint32_t x, const std::uint32_t y)
+{
+    const std::uint32_t p = x * y + 128;
+    return (p + (p >> 8)) >> 8;
+}
+
+// source-over blending of `count` RGBA pixels, as glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA):
+// contiguous and branch-free so that the compiler vectorizes it (the file is always built with -O3)
+void blend_span(std::uint8_t* __restrict dst, const std::uint8_t* __restrict src, const size_t count)
+{
+    for (size_t i = 0; i < count * 4; i += 4) {
+        const std::uint32_t alpha = src[i + 3];
+        for (size_t c = 0; c < 4; c++) {
+            dst[i + c] = static_cast<std::uint8_t>(mul_255(src[i + c], alpha) + mul_255(dst[i + c], 255 - alpha));
+        }
+    }
+}
+
+} // namespace
+
+SoftwareRenderer::SoftwareRenderer(const TextureAtlas& atlas_, const unsigned width_, const unsigned height_) :
+    atlas { atlas_ }, width { width_ }, height { height_ }, pixels(static_cast<size_t>(width_) * height_ * 4), span(width_ * 4)
+{
+    assert(!atlas.get_pixels().empty());
+}
+
+void SoftwareRenderer::render(const Snapshot& frame, const std::pair<Point2D, Point2D>& view)
+{
+    for (size_t i = 0; i < pixels.size(); i += 4) {                // Opaque black, as the GL clear color
+        pixels[i] = pixels[i + 1] = pixels[i + 2] = 0;
+        pixels[i + 3] = 255;
+    }
+    for (const auto& sprite : frame.sprites) draw_sprite(sprite, view);
+}
+
+// nearest texel of the tile (level 0 of the atlas) for each covered pixel center
+void SoftwareRenderer::draw_sprite(const Sprite& sprite, const std::pair<Point2D, Point2D>& view)
+{
+    const auto& [min, max] = view;
+    const float scale_x = width / (max.x() - min.x()), scale_y = height / (max.y() - min.y());
+    const Point2D pos  = sprite.position(1.f);
+    const Point2D half = sprite.dim * .5f;
+    // the quad in pixels, y going down
+    const float left = (pos.x() - half.x() - min.x()) * scale_x, right = (pos.x() + half.x() - min.x()) * scale_x;
+    const float top = (max.y() - pos.y() - half.y()) * scale_y, bottom = (max.y() - pos.y() + half.y()) * scale_y;
+    const int x0 = std::max(static_cast<int>(std::ceil(left - .5f)), 0);
+    const int x1 = std::min(static_cast<int>(std::ceil(right - .5f)), static_cast<int>(width));
+    const int y0 = std::max(static_cast<int>(std::ceil(top - .5f)), 0);
+    const int y1 = std::min(static_cast<int>(std::ceil(bottom - .5f)), static_cast<int>(height));
+    if (x0 >= x1 || y0 >= y1) return;
+
+    const auto [u0, v0, u1, v1] = sprite.region->tile_uv(sprite.tile_at(1.f));
+    const unsigned atlas_width = atlas.get_width(), atlas_height = atlas.get_height();
+    const std::uint8_t* texels = atlas.get_pixels().data();
+    const float du = (u1 - u0) / (right - left), dv = (v1 - v0) / (bottom - top);
+    const auto texel_column = [&](const int x) {
+        const float u = u0 + (x + .5f - left) * du;
+        return std::min(static_cast<unsigned>(u * atlas_width), atlas_width - 1);
+    };
+    for (int y = y0; y < y1; y++) {
+        const float v    = v0 + (y + .5f - top) * dv;
+        const unsigned row = std::min(static_cast<unsigned>(v * atlas_height), atlas_height - 1);
+        const std::uint8_t* texel_row = texels + static_cast<size_t>(row) * atlas_width * 4;
+        for (int x = x0; x < x1; x++) {                                 // Gather, then blend the whole span
+            std::copy_n(texel_row + texel_column(x) * 4, 4, span.data() + (x - x0) * 4);
+        }
+        blend_span(pixels.data() + (static_cast<size_t>(y) * width + x0) * 4, span.data(), x1 - x0);
+    }
+}
+
+} // namespace GL
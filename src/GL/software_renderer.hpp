@@ -0,0 +1,37 @@
+#pragma once
+
+#include "atlas.hpp"
+#include "snapshot.hpp"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace GL {
+
+// CPU rasterizer of the snapshots, for the machines without a GPU: the sprites are drawn as in
+// display(), alpha-blended back to front into an RGBA framebuffer, from the pixels of an atlas
+// built without upload. The trails and the overlays are not drawn.
+class SoftwareRenderer
+{
+public:
+    SoftwareRenderer(const TextureAtlas& atlas_, unsigned width_, unsigned height_);
+
+    // draw the snapshot as seen by a camera whose view is [min, max] (see Camera::view)
+    void render(const Snapshot& frame, const std::pair<Point2D, Point2D>& view);
+
+    [[nodiscard]] const std::vector<std::uint8_t>& get_pixels() const { return pixels; }
+    [[nodiscard]] unsigned get_width() const { return width; }
+    [[nodiscard]] unsigned get_height() const { return height; }
+
+private:
+    const TextureAtlas& atlas;
+    const unsigned width;
+    const unsigned height;
+    std::vector<std::uint8_t> pixels;
+    std::vector<std::uint8_t> span;                 // texels of the row being drawn, blended in a second pass
+
+    void draw_sprite(const Sprite& sprite, const std::pair<Point2D, Point2D>& view);
+};
+
+} // namespace GL
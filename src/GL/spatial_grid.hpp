@@ -0,0 +1,101 @@
+#pragma once
+
+#include "../allocation.hpp"
+#include "../config.hpp"
+#include "../geometry.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+namespace GL {
+
+class Displayable;
+
+// where a displayable is filed in the grid (owned by the displayable)
+struct GridSlot
+{
+    static constexpr unsigned NONE = ~0u;
+    unsigned cell  = NONE;
+    unsigned index = 0;
+};
+
+// Uniform grid over the screen plane, DISPLAY_GRID_DIM cells per side centred on the origin.
+// not filed by position (large sprites such as the airport) and
+// not filed by position (large sprites, aircraft flying their closed-form holding pattern...) and
+// is always visited, so a query costs the visible cells plus the loose objects.
+class SpatialGrid
+{
+public:
+    static constexpr unsigned LOOSE = DISPLAY_GRID_DIM * DISPLAY_GRID_DIM;
+
+    SpatialGrid() : cells(LOOSE + 1) {}
+
+    [[nodiscard]] unsigned cell_of(const Point2D& pos) const { return row_of(pos.y()) * DISPLAY_GRID_DIM + column_of(pos.x()); }
+
+    void insert(const Displayable* item, GridSlot& slot, const unsigned cell)
+    {
+        assert(slot.cell == GridSlot::NONE && cell <= LOOSE);
+        auto& entries = cells[cell];
+        if (entries.size() == entries.capacity()) alloc::mark_unsteady();   // The cell grows
+        slot = { cell, static_cast<unsigned>(entries.size()) };
+        entries.push_back({ item, &slot });
+        count++;
+    }
+
+    void erase(GridSlot& slot)
+    {
+        assert(slot.cell != GridSlot::NONE);
+        auto& entries = cells[slot.cell];
+        entries[slot.index] = entries.back();                               // Swap with the last one
+        entries[slot.index].slot->index = slot.index;
+        entries.pop_back();
+        slot = {};
+        count--;
+    }
+
+    void move(GridSlot& slot, const unsigned cell)
+    {
+        if (slot.cell == cell) return;
+        const Displayable* item = cells[slot.cell][slot.index].item;
+        erase(slot);
+        insert(item, slot, cell);
+    }
+
+    // append the objects of the loose list and of the cells overlapping [min, max]
+    template<typename Container>
+    void collect(const Point2D& min, const Point2D& max, Container& out) const
+    {
+        const auto add = [&out](const std::vector<Entry>& entries) {
+            for (const auto& entry : entries) out.push_back(entry.item);
+        };
+        add(cells[LOOSE]);
+        for (unsigned row = row_of(min.y()); row <= row_of(max.y()); row++) {
+            for (unsigned column = column_of(min.x()); column <= column_of(max.x()); column++) {
+                add(cells[row * DISPLAY_GRID_DIM + column]);
+            }
+        }
+    }
+
+    [[nodiscard]] size_t size() const { return count; }
+
+private:
+    struct Entry
+    {
+        const Displayable* item;
+        GridSlot* slot;
+    };
+
+    std::vector<std::vector<Entry>> cells;
+    size_t count = 0;
+
+    static unsigned index_of(const float coordinate)
+    {
+        const float shifted = coordinate / DISPLAY_GRID_CELL + DISPLAY_GRID_DIM / 2.f;
+        return static_cast<unsigned>(std::clamp(shifted, 0.f, DISPLAY_GRID_DIM - 1.f));
+    }
+    static unsigned row_of(const float y) { return index_of(y); }
+    static unsigned column_of(const float x) { return index_of(x); }
+};
+
+} // namespace GL
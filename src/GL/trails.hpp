@@ -0,0 +1,74 @@
+#pragma once
+
+#include "../allocation.hpp"
+#include "../config.hpp"
+#include "../geometry.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace GL {
+
+// Last TRAIL_LENGTH screen positions of each aircraft, as ring buffers laid out one after the other
+// in a single array indexed by the aircraft's pool slot. The memory is slots * TRAIL_LENGTH points,
+// allocated when the aircraft pool grows and never freed.
+class TrailPool
+{
+public:
+    void clear(const size_t slot)
+    {
+        if (slot < rings.size()) rings[slot] = {};
+    }
+
+    void clear_all() { std::fill(rings.begin(), rings.end(), Ring {}); }
+
+    // keep the position if it is far enough from the previous one
+    void record(const size_t slot, const Point2D& pos)
+    {
+        if (slot >= rings.size()) grow(slot + 1);
+        Ring& ring = rings[slot];
+        if (ring.count > 0 && newest(slot).distance_to(pos) < TRAIL_SPACING) return;
+        ring.head = (ring.head + 1) % TRAIL_LENGTH;
+        points[slot * TRAIL_LENGTH + ring.head] = pos;
+        if (ring.count < TRAIL_LENGTH) ring.count++;
+    }
+
+    // append the trail as pairs of points (the segments of a GL_LINES batch), oldest first
+    void append_segments(const size_t slot, std::vector<Point2D>& segments) const
+    {
+        if (slot >= rings.size()) return;
+        const Ring& ring   = rings[slot];
+        const size_t first = (ring.head + TRAIL_LENGTH - ring.count + 1) % TRAIL_LENGTH;
+        for (unsigned i = 1; i < ring.count; i++) {
+            segments.push_back(points[slot * TRAIL_LENGTH + (first + i - 1) % TRAIL_LENGTH]);
+            segments.push_back(points[slot * TRAIL_LENGTH + (first + i) % TRAIL_LENGTH]);
+        }
+    }
+
+private:
+    struct Ring
+    {
+        std::uint16_t head  = 0;
+        std::uint16_t count = 0;
+    };
+
+    std::vector<Point2D> points;
+    std::vector<Ring> rings;
+
+    [[nodiscard]] const Point2D& newest(const size_t slot) const { return points[slot * TRAIL_LENGTH + rings[slot].head]; }
+
+    void grow(const size_t slots)
+    {
+        alloc::mark_unsteady();
+        rings.resize(std::max(slots, rings.size() * 2));
+        points.resize(rings.size() * TRAIL_LENGTH, Point2D { 0.f, 0.f });
+    }
+};
+
+// simulation thread only: toggled by a keystroke
+inline bool trails_enabled = false;
+inline TrailPool trails;
+
+} // namespace GL
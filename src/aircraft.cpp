@@ -1,16 +1,59 @@
 #include "aircraft.hpp"
 
 #include "GL/opengl_interface.hpp"
+#include "aircraft_sprites.hpp"
+#include "GL/glyphs.hpp"
+#include "GL/label_placer.hpp"
+#include "GL/trails.hpp"
 #include "aircraftCrash.hpp"
 
+#include <algorithm>
 #include <cmath>
+#include <cstdio>
 
 
 Aircraft::~Aircraft() {
-    control.on_aircraft_crash(*this);
+    if (active) control->on_aircraft_crash(*this);
 }
 
-void Aircraft::turn_to_waypoint()
+void Aircraft::reset(const AircraftTypeId type_, const std::string_view& flight_number_, const Point3D& pos_,
+                     const Point3D& speed_, Tower& control_)
+{
+    assert(!active);
+    type_id               = type_;
+    flight_number         = flight_number_;         // Reuses the storage of the previous flight number
+    pos                   = pos_;
+    speed                 = speed_;
+    waypoints.clear();
+    control               = &control_;
+    landing_gear_deployed = false;
+    is_at_terminal        = false;
+    serviced              = false;
+    arrival_slot          = ArrivalScheduler::NOT_WAITING;
+    terminal              = NO_TERMINAL;
+    holding               = false;
+    update_period         = 1;
+    pending_dt            = 0;
+    active                = true;
+    fuel                  = compute_initial_fuel(type());
+    speed.cap_length(max_speed());
+    label_fuel            = -1;                             // New flight number
+    show();
+    update_screen();
+    glide_from  = glide_to;                                 // Appears where it is, without sliding from its previous flight
+    glide_ticks = 0;
+    glide();
+    start_tick();
+}
+
+void Aircraft::retire()
+{
+    assert(active);
+    active = false;
+    hide();
+}
+
+void Aircraft::turn_to_waypoint(const float scale)
 {
     if (!waypoints.empty())
     {
@@ -22,20 +65,20 @@ void Aircraft::turn_to_waypoint()
             target += W;
         }
         auto t = target - pos - speed;
-        turn(t);
+        turn(t, scale);
     }
 }
 
-void Aircraft::turn(Point3D& direction)
+void Aircraft::turn(Point3D& direction, const float scale)
 {
-    (speed += direction.cap_length(type.max_accel)).cap_length(max_speed());
+    (speed += direction.cap_length(type().max_accel * scale)).cap_length(max_speed());
 }
 
-unsigned int Aircraft::get_speed_octant() const
+unsigned int Aircraft::get_speed_octant(const Point3D& velocity)
 {
-    const float speed_len = speed.length();
+    const float speed_len = velocity.length();
     if (speed_len <= 0) return 0;
-    const Point3D norm_speed{speed * (1.0f / speed_len)};
+    const Point3D norm_speed{velocity * (1.0f / speed_len)};
     const float angle =
             (norm_speed.y() > 0) ? 2.0f * 3.141592f - std::acos(norm_speed.x()) : std::acos(norm_speed.x());
     // partition into NUM_AIRCRAFT_TILES equal pieces
@@ -43,11 +86,105 @@ unsigned int Aircraft::get_speed_octant() const
            NUM_AIRCRAFT_TILES;
 }
 
-// when we arrive at a terminal, signal the tower
+double Aircraft::hold_elapsed() const
+{
+    assert(holding);
+    return control->now() - hold_start;
+}
+
+Point3D Aircraft::current_position() const
+{
+    return holding ? control->get_holding_pattern().position(hold_arc()) : pos;
+}
+
+Point3D Aircraft::current_speed() const
+{
+    return holding ? control->get_holding_pattern().direction(hold_arc()) * type().max_air_speed : speed;
+}
+
+void Aircraft::enter_holding(const Point3D& corner)
+{
+    assert(!holding && is_waiting_terminal());
+    holding     = true;
+    hold_start  = control->now();
+    hold_offset = control->get_holding_pattern().offset_of(corner);
+    waypoints.clear();
+    control->update_deadline(*this);                                        // Now flying at full speed
+    track_holding();
+}
+
+void Aircraft::track_holding()
+{
+    update_screen();
+}
+
+void Aircraft::start_tick()
+{
+    previous_screen_pos = screen_pos;
+    previous_tile       = tile;
+}
+
+void Aircraft::update_screen()
+{
+    const Point3D position = current_position();                            // Follows the lap while holding
+    GL::Displayable::z     = position.x() + position.y();
+    glide_from             = screen_pos;                                    // Where it is drawn now
+    glide_to               = project_2D(position);
+    glide_ticks            = 0;
+    tile                   = get_speed_octant(current_speed());
+}
+
+void Aircraft::glide()
+{
+    const unsigned length = glide_length();
+    glide_ticks           = std::min(glide_ticks + 1, length);
+    screen_pos            = glide_from + (glide_to - glide_from) * (static_cast<float>(glide_ticks) / length);
+    place(screen_pos);
+}
+
+void Aircraft::update_overlays()
+{
+    if (GL::trails_enabled) GL::trails.record(handle.slot, screen_pos);
+    if (!GL::labels_enabled) return;
+    static constexpr std::array<std::string_view, static_cast<size_t>(FlightPhase::count)> phase_codes {
+        "INB", "HLD", "APP", "GATE", "DEP"
+    };
+    const FlightPhase current = phase();
+    const int fuel_shown      = std::clamp(static_cast<int>(current_fuel()), 0, 9'999);
+    if (fuel_shown == label_fuel && current == label_phase) return;
+    char line[2 * LABEL_LINE_LENGTH + 1];
+    std::snprintf(line, sizeof(line), "%-*.*s%4d %-4s", LABEL_LINE_LENGTH, LABEL_LINE_LENGTH, flight_number.c_str(),
+                  fuel_shown, phase_codes[static_cast<size_t>(current)].data());
+    for (size_t i = 0; i < label_glyphs.size(); i++) label_glyphs[i] = GL::glyph_index(line[i]);
+    label_fuel  = fuel_shown;
+    label_phase = current;
+}
+
+void Aircraft::leave_holding()
+{
+    assert(holding);
+    const float arc = hold_arc();
+    fuel    = current_fuel();
+    pos     = control->get_holding_pattern().position(arc);
+    speed   = control->get_holding_pattern().direction(arc) * type().max_air_speed;
+    holding       = false;
+    update_period = 1;                                                      // Fine steps from now on
+    pending_dt    = 0;                                                      // Already covered by the closed form
+    update_screen();
+}
+
+unsigned Aircraft::next_update_period(const double tick_dt) const
+{
+    if (holding) return INBOUND_UPDATE_PERIOD;                              // Nothing to integrate anyway
+    if (is_at_terminal || is_on_ground() || has_terminal() || waypoints.empty()) return 1;
+    const float reach = speed.length() * static_cast<float>(tick_dt) * INBOUND_UPDATE_PERIOD;
+    return distance_to(waypoints.front()) > 2 * reach + DISTANCE_THRESHOLD ? INBOUND_UPDATE_PERIOD : 1;
+}
+
+// when we arrive at a terminal, the AircraftManager signals it to the tower
 void Aircraft::arrive_at_terminal()
 {
     assert(is_at_terminal == false);
-    control.arrived_at_terminal(*this);  // we arrived at a terminal, so start servicing
     is_at_terminal = true;
 }
 
@@ -62,12 +199,12 @@ bool Aircraft::operate_landing_gear()
     // deploy/retract landing gear when landing/lifting-off
     if (ground_before && !ground_after)
     {
-        if (!SILENT_TERMINAL) std::cout << flight_number << " lift off" << std::endl;
+        if (!SILENT_TERMINAL) std::cout << flight_number << " lift off\n";
         return true;
     }
     if (!ground_before && ground_after)
     {
-        if (!SILENT_TERMINAL) std::cout << flight_number << " is now landing..." << std::endl;
+        if (!SILENT_TERMINAL) std::cout << flight_number << " is now landing...\n";
         landing_gear_deployed = true;
     }
     else if (!ground_before)
@@ -77,60 +214,118 @@ bool Aircraft::operate_landing_gear()
     return false;
 }
 
-// Move the aircraft and return True if the aircraft need to be destroyed
+FlightPhase Aircraft::phase() const
+{
+    if (holding) return FlightPhase::holding;
+    if (is_at_terminal) return FlightPhase::at_gate;
+    if (serviced) return FlightPhase::departing;
+    if (has_terminal()) return FlightPhase::approach;
+    return FlightPhase::inbound;
+}
+
+// Fly the aircraft and return True if the aircraft need to be destroyed
 // A destruction appear in 2 cases: No fuel left and lifting off.
-bool Aircraft::move(double dt)
+// Large time steps are split in equal substeps, short enough for the turns to
+// stay accurate and for no waypoint to be jumped over.
+bool Aircraft::fly(const double dt)
 {
-    assert(dt > 0);
+    assert(dt >= 0 && !holding && !is_at_terminal);
     if (fuel <= 0)                                                          // Crash if no fuel
         throw AircraftCrash {flight_number, pos, speed, out_of_fuel};
+
+    for (double remaining = dt; remaining > 0 && !is_at_terminal && !holding;)
+    {
+        const double h = std::min(remaining, max_substep());                // The last substep ends exactly at dt
+        if (step(h)) return true;
+        remaining -= h;
+    }
+
+    update_screen();                                                        // Update z and the drawn position
+    return false;
+}
+
+double Aircraft::max_substep() const
+{
+    const double turning = MAX_SUBSTEP_DISTANCE / std::max(max_speed(), speed.length());
+    if (waypoints.empty() || speed.length() < SPEED_THRESHOLD) return std::min(MAX_SUBSTEP, turning);
+    Point3D target = waypoints[0] - pos;                                    // The heading turn_to_waypoint() aims at
+    if (waypoints.size() > 1) target += (waypoints[0] - waypoints[1]).normalize(target.length() / 2.0f);
+    const float alignment = target.dot(speed) / (target.length() * speed.length());
+    return alignment > STRAIGHT_LEG_COS ? MAX_SUBSTEP : std::min(MAX_SUBSTEP, turning);
+}
+
+// Integrate a single substep of duration h.
+// The waypoint is reached when the segment flown passes close enough to it.
+bool Aircraft::step(const double h)
+{
+    const auto scale = static_cast<float>(h / RATE_TIME_STEP);              // Turn and sink rates are given per RATE_TIME_STEP
     if (!is_on_ground()) {                                                  // Decrease fuel level
-        fuel -= dt * type.fuel_consumption * (speed.length() / max_speed());
+        fuel -= h * type().fuel_consumption * (speed.length() / max_speed());
+        if (fuel <= 0) throw AircraftCrash {flight_number, pos, speed, out_of_fuel};
     }
     if (waypoints.empty()) {                                                // Update path when empty
-        for (const auto& wp: control.get_instructions(*this))
+        for (const auto& wp: control->get_instructions(*this))
         {
             const bool front = false;
             add_waypoint<front>(wp);
         }
     }
-    if (is_circling()) {                                                    // If making circles
-        auto wp = control.reserve_terminal(*this);                          // Try to update the path
-        if (!wp.empty()) {
-            waypoints = wp;                                                 // If path to terminal update the path
-        }
-    }
-    if (is_at_terminal) return false;                                       // If serviced don't move
-    turn_to_waypoint();                                                     // Rotate
-    pos += speed * static_cast<float>(dt);                                  // Move
+    turn_to_waypoint(scale);                                                // Rotate
+    const Point3D from = pos;
+    pos += speed * static_cast<float>(h);                                   // Move
 
-    if (!waypoints.empty() && distance_to(waypoints.front()) < DISTANCE_THRESHOLD)  // If close enough, remove the waypoint
+    if (!waypoints.empty())
     {
-        if (waypoints.front().is_at_terminal()) arrive_at_terminal();               // If at terminal -> service
-        else if (operate_landing_gear()) return true;                               // If not at terminal and lifting off -> destroy
-        waypoints.pop_front();                                                      // Remove waypoint
+        const Point3D closest = closest_on_segment(waypoints.front(), from, pos);
+        if (closest.distance_to(waypoints.front()) < DISTANCE_THRESHOLD)        // If close enough, remove the waypoint
+        {
+            pos = closest;                                                      // Stop where the waypoint was reached
+            if (waypoints.front().is_at_terminal()) arrive_at_terminal();       // If at terminal -> service
+            else if (operate_landing_gear()) return true;                       // If not at terminal and lifting off -> destroy
+            const Point3D reached = waypoints.front();
+            waypoints.pop_front();                                              // Remove waypoint
+            if (is_waiting_terminal()) enter_holding(reached);                  // Waiting at a corner of the circle
+        }
     }
 
-    if (is_on_ground() && !landing_gear_deployed)                                   // Invalid state caused by speed
+    if (is_on_ground() && !landing_gear_deployed)                               // Invalid state caused by speed
         throw AircraftCrash {flight_number, pos, speed, bad_landing};
-    if (!is_on_ground() && speed.length() < SPEED_THRESHOLD)                        // If flying to slow -> sink
-        pos.z() -= SINK_FACTOR * (SPEED_THRESHOLD - speed.length());
-
-    GL::Displayable::z = pos.x() + pos.y();                                         // Update z
+    if (!is_on_ground() && speed.length() < SPEED_THRESHOLD)                    // If flying to slow -> sink
+        pos.z() -= SINK_FACTOR * (SPEED_THRESHOLD - speed.length()) * scale;
     return false;
 }
 
-void Aircraft::display() const
+void Aircraft::display(GL::Snapshot& frame) const
 {
-    type.texture.draw(project_2D(pos), { PLANE_TEXTURE_DIM, PLANE_TEXTURE_DIM }, get_speed_octant());
+    if (GL::trails_enabled) GL::trails.append_segments(handle.slot, frame.trail_segments);
+    if (GL::labels_enabled) display_label(frame);
+    frame.add_moving_sprite(GL::get_aircraft_sprite(type_id), previous_screen_pos, screen_pos,
+                            { PLANE_TEXTURE_DIM, PLANE_TEXTURE_DIM }, previous_tile, tile);
 }
-bool Aircraft::is_circling() const
+
+void Aircraft::display_label(GL::Snapshot& frame) const
 {
-    return !waypoints.empty() && !waypoints.back().is_on_ground() && !landing_gear_deployed;
+    const Point2D pixel = frame.pixel;                                      // The label is laid out in pixels
+    const Point2D corner { screen_pos.x() / pixel.x() + LABEL_OFFSET_X,     // Top-left corner of the label
+                           screen_pos.y() / pixel.y() + LABEL_OFFSET_Y };
+    if (!frame.labels.reserve({ corner.x(), corner.y() - 2 * GL::LABEL_LINE_HEIGHT },
+                              { corner.x() + LABEL_LINE_LENGTH * GL::LABEL_ADVANCE, corner.y() })) {
+        return;
+    }
+    const Point2D offset { LABEL_OFFSET_X * pixel.x(), LABEL_OFFSET_Y * pixel.y() };
+    const Point2D from = previous_screen_pos + offset, to = screen_pos + offset;
+    const Point2D dim { GL::GLYPH_COLUMNS * LABEL_GLYPH_SCALE * pixel.x(), GL::GLYPH_ROWS * LABEL_GLYPH_SCALE * pixel.y() };
+    for (size_t i = 0; i < label_glyphs.size(); i++) {
+        if (label_glyphs[i] == 0) continue;                                 // Nothing to draw for a space
+        const Point2D center { (i % LABEL_LINE_LENGTH + .5f) * GL::LABEL_ADVANCE * pixel.x(),
+                               -(i / LABEL_LINE_LENGTH + .5f) * GL::LABEL_LINE_HEIGHT * pixel.y() };
+        frame.add_moving_sprite(*GL::glyph_sheet, from + center, to + center, dim, label_glyphs[i], label_glyphs[i]);
+    }
 }
-bool Aircraft::has_terminal() const
+
+bool Aircraft::is_circling() const
 {
-    return !waypoints.empty() && waypoints.back().is_at_terminal();
+    return !waypoints.empty() && !waypoints.back().is_on_ground() && !landing_gear_deployed;
 }
 
 bool Aircraft::operator<(const Aircraft &rhs) const {
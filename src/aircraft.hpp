@@ -1,31 +1,70 @@
 #pragma once
 
 #include "GL/displayable.hpp"
+#include "aircraft_handle.hpp"
+#include "aircraftCrash.hpp"
 #include "aircraft_types.hpp"
+#include "arrival_scheduler.hpp"
 #include "config.hpp"
 #include "geometry.hpp"
 #include "tower.hpp"
 #include "waypoint.hpp"
 
+#include <array>
+#include <cstdint>
 #include <string>
 #include <string_view>
 #include <cmath>
+#include <limits>
+
+// groups of the AircraftManager, each one updated by its own kernel (taxiing is part of the
+// approach and departing phases: the ground and air physics are the same integration)
+enum class FlightPhase { inbound, holding, approach, at_gate, departing, count };
 
 class Aircraft : public GL::Displayable
 {
 friend std::ostream& operator<<(std::ostream& stream, const Aircraft& aircraft) {
     return stream << "Aircraft: " << aircraft.flight_number << " | " << aircraft.has_terminal()
-    << " | " << aircraft.fuel << " | " << aircraft.type.min_fuel() << " | " << aircraft.type.max_fuel;
+    << " | " << aircraft.fuel << " | " << aircraft.type().min_fuel << " | " << aircraft.type().max_fuel;
 }
 private:
-    const AircraftType& type;               // The life time of this field is less than the container in AircraftFactory so no dangling ref here
-    const std::string flight_number;        // Aircraft identifier
+    AircraftTypeId type_id;                 // Index in the aircraft type table
+    std::string flight_number;              // Aircraft identifier
     Point3D pos, speed;                     // note: the speed should always be normalized to length 'speed'
     WaypointQueue waypoints = {};           // Path of the aircraft
-    Tower& control;                         // Reference to the Tower
+    Tower* control;                         // Pointer to the Tower
     bool landing_gear_deployed = false;     // is the landing gear deployed?
     bool is_at_terminal        = false;     // is the aircraft at a terminal
+    bool serviced              = false;     // has the aircraft left its terminal
+    size_t arrival_slot        = ArrivalScheduler::NOT_WAITING;     // position in the tower's arrival queue
+    size_t terminal            = NO_TERMINAL;   // terminal reserved by the tower
+    AircraftHandle handle      = {};        // slot in the AircraftManager's pool and generation of the flight
+    bool active                = false;     // is the aircraft flying (false when waiting in the pool)
     double fuel                = 0;         // fuel level
+    AircraftCrashReason crash_reason = out_of_fuel;     // set by the AircraftManager when the aircraft crashes
+    // closed-form holding: pos, speed and fuel are frozen at hold_start, the aircraft flies the
+    // tower's holding pattern at full speed from the arc length hold_offset
+    bool holding               = false;
+    double hold_start          = 0;
+    float hold_offset          = 0;
+    // multi-rate update (handled by the AircraftManager)
+    unsigned update_period     = 1;         // ticks between two moves
+    unsigned stagger           = 0;         // offset spreading the coarse moves over the ticks
+    double pending_dt          = 0;         // time accumulated since the last move
+    // screen position and tile drawn at this tick and one tick earlier (the frames in between are interpolated)
+    Point2D screen_pos          = {};
+    unsigned tile               = 0;
+    Point2D previous_screen_pos = {};
+    unsigned previous_tile      = 0;
+    // a move glides the drawn position from glide_from to glide_to over the ticks until the next move,
+    // so that coarse moves are drawn as steady motion rather than a jump every update_period ticks
+    Point2D glide_from          = {};
+    Point2D glide_to            = {};
+    unsigned glide_ticks        = 0;        // ticks since the last move
+    // glyphs of the flight data label, laid out again only when the rounded fuel or the phase changes
+    std::array<std::uint8_t, 2 * LABEL_LINE_LENGTH> label_glyphs {};
+    int label_fuel              = -1;
+    FlightPhase label_phase     = FlightPhase::count;
 
     // turn the aircraft to arrive at the next waypoint
     // try to facilitate reaching the waypoint after the next by facing the
@@ -33,21 +72,50 @@ private:
     // the next two waypoints such that Z's distance to the next waypoint is
     // half our distance so: |w1 - pos| = d and [w1 - w2].normalize() = W and Z
     // = w1 + W*d/2
-    void turn_to_waypoint();
-    void turn(Point3D& direction);
+    // the acceleration is scaled by the length of the substep (1 for RATE_TIME_STEP)
+    void turn_to_waypoint(float scale);
+    void turn(Point3D& direction, float scale);
+    // integrate one substep of fly(), returns true when lifting off
+    bool step(double h);
+    // file a holding aircraft under its closed-form position (done every tick by the AircraftManager)
+    void track_holding();
+    // the drawn position of the previous tick (called by the AircraftManager before moving the aircraft)
+    void start_tick();
+    // project the new position and tile after a move, the drawn position glides to it
+    void update_screen();
+    // advance the drawn position and the culling cell by a tick (called by the AircraftManager after moving)
+    void glide();
+    // ticks the glide lasts: until the next coarse move, a tick while holding (tracked every tick)
+    [[nodiscard]] unsigned glide_length() const { return holding ? 1u : update_period; }
+    // record the trail and lay the label out again if needed (called by the AircraftManager after each tick)
+    void update_overlays();
+    // longest accurate substep: the crossing test of step() handles a straight leg, turns need short pieces
+    [[nodiscard]] double max_substep() const;
 
     // select the correct tile in the plane texture (series of 8 sprites facing
     // [North, NW, W, SW, S, SE, E, NE])
-    [[nodiscard]] unsigned int get_speed_octant() const;
+    [[nodiscard]] static unsigned int get_speed_octant(const Point3D& velocity);
+    // add the two lines of the label (flight number, then fuel and phase) next to the aircraft, if there is room
+    void display_label(GL::Snapshot& frame) const;
+    // switch to closed-form holding after reaching a corner of the holding pattern
+    void enter_holding(const Point3D& corner);
+    // back to per-tick physics (when cleared to land or out of fuel)
+    void leave_holding();
+    [[nodiscard]] double hold_elapsed() const;
+    [[nodiscard]] float hold_arc() const { return hold_offset + type().max_air_speed * static_cast<float>(hold_elapsed()); }
+    [[nodiscard]] Point3D current_position() const;
+    [[nodiscard]] Point3D current_speed() const;
+    // coarse moves are allowed when flying to a waypoint that cannot be reached before the next move
+    [[nodiscard]] unsigned next_update_period(double tick_dt) const;
     // when we arrive at a terminal, signal the tower
     void arrive_at_terminal();
     // deploy and retract landing gear depending on next waypoints
     bool operate_landing_gear();
     [[nodiscard]] bool is_on_ground() const { return pos.z() < DISTANCE_THRESHOLD; }
-    [[nodiscard]] float max_speed() const { return is_on_ground() ? type.max_ground_speed : type.max_air_speed; }
+    [[nodiscard]] float max_speed() const { return is_on_ground() ? type().max_ground_speed : type().max_air_speed; }
     double static compute_initial_fuel(const AircraftType& type) {
-        const double f = std::rand() % (type.max_fuel - static_cast<int>(type.min_fuel()));
-        return type.min_fuel() + f;
+        const double f = std::rand() % (type.max_fuel - static_cast<int>(type.min_fuel));
+        return type.min_fuel + f;
     }
     template<bool front = false>
     void add_waypoint(const Waypoint& wp) {
@@ -56,29 +124,53 @@ private:
     }
 
 public:
+    static constexpr size_t NO_TERMINAL = std::numeric_limits<size_t>::max();
+
     Aircraft(const Aircraft&) = delete;
     Aircraft& operator=(const Aircraft&) = delete;
     ~Aircraft() override;
-    Aircraft(const AircraftType& type_, const std::string_view& flight_number_, const Point3D& pos_,
+    Aircraft(const AircraftTypeId type_, const std::string_view& flight_number_, const Point3D& pos_,
              const Point3D& speed_, Tower& control_) :
-        GL::Displayable { pos_.x() + pos_.y() },
-        type { type_ },
-        flight_number { flight_number_ },
-        pos { pos_ },
-        speed { speed_ },
-        control { control_ },
-        fuel {compute_initial_fuel(type_)}
+        GL::Displayable { pos_.x() + pos_.y() }
     {
-        speed.cap_length(max_speed());
+        reset(type_, flight_number_, pos_, speed_, control_);
     }
 
+    // reinitialize a retired aircraft so that it can be reused for a new flight
+    void reset(const AircraftTypeId type_, const std::string_view& flight_number_, const Point3D& pos_,
+               const Point3D& speed_, Tower& control_);
+    // stop displaying the aircraft (the tower learnt about its departure or crash from the lifecycle events)
+    void retire();
+
     [[nodiscard]] const std::string& get_flight_num() const { return flight_number; }
+    [[nodiscard]] AircraftHandle get_handle() const { return handle; }
+    [[nodiscard]] const AircraftType& type() const { return get_aircraft_type(type_id); }
     [[nodiscard]] float distance_to(const Point3D& p) const { return pos.distance_to(p); }
-    [[nodiscard]] bool is_low_on_fuel() const { return fuel < type.min_fuel(); }
-    [[nodiscard]] unsigned get_missing_fuel() const { return type.max_fuel - (unsigned)std::ceil(fuel); }
+    [[nodiscard]] bool is_low_on_fuel() const { return fuel < type().min_fuel; }
+    [[nodiscard]] unsigned get_missing_fuel() const { return type().max_fuel - (unsigned)std::ceil(fuel); }
+    [[nodiscard]] double current_fuel() const {
+        return holding ? fuel - type().fuel_consumption * hold_elapsed() : fuel;
+    }
+    // time before running out of fuel at the current speed
+    [[nodiscard]] double time_to_empty() const {
+        if (holding) return current_fuel() / type().fuel_consumption;
+        const double rate = type().fuel_consumption * std::max(speed.length() / max_speed(), SPEED_THRESHOLD);
+        return fuel / rate;
+    }
+    [[nodiscard]] bool is_inbound() const { return !serviced && !is_at_terminal; }
+    [[nodiscard]] bool is_parked() const { return is_at_terminal; }
+    // inbound aircraft that has not asked the tower for a terminal yet
+    [[nodiscard]] bool needs_terminal() const { return !serviced && !is_waiting_terminal() && !has_terminal(); }
+    [[nodiscard]] bool is_waiting_terminal() const { return arrival_slot != ArrivalScheduler::NOT_WAITING; }
 
+    [[nodiscard]] FlightPhase phase() const;
     [[nodiscard]] bool is_circling() const;
-    [[nodiscard]] bool has_terminal() const;
+    [[nodiscard]] bool has_terminal() const { return terminal != NO_TERMINAL; }
+    // where and why the aircraft crashed (valid until its crash event is dispatched)
+    [[nodiscard]] std::string crash_report() const
+    {
+        return AircraftCrash::build_error_msg(flight_number, pos, speed, crash_reason);
+    }
     void refill(unsigned&);
 
     bool operator<(const Aircraft &rhs) const;
@@ -86,8 +178,12 @@ public:
     bool operator<=(const Aircraft &rhs) const;
     bool operator>=(const Aircraft &rhs) const;
 
-    void display() const override;
-    bool move(double);
+    void display(GL::Snapshot& frame) const override;
+    // integrate the flight for dt (phase-specific work is done by the AircraftManager kernels)
+    // return true if the aircraft lifted off
+    bool fly(double);
 
     friend class Tower;
+    friend class ArrivalScheduler;
+    friend class AircraftManager;
 };
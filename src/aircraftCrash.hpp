@@ -1,6 +1,7 @@
 #pragma once
 
 #include "geometry.hpp"
+#include <cassert>
 #include <stdexcept>
 #include <ostream>
 
@@ -10,11 +11,12 @@ class AircraftCrash : public std::runtime_error {
 public:
     AircraftCrash(const std::string& flight_number, const Point3D& pos,
                   const Point3D& speed, const AircraftCrashReason& reason)
-        : std::runtime_error {build_error_msg(flight_number, pos, speed, reason)}
+        : std::runtime_error {build_error_msg(flight_number, pos, speed, reason)}, crash_reason {reason}
     {
         assert(!flight_number.empty());
     }
-private:
+    [[nodiscard]] AircraftCrashReason get_reason() const { return crash_reason; }
+    // the report of the crash, also written by the FlightLog when the crash event is dispatched
     static std::string build_error_msg(const std::string& flight_number, const Point3D& pos,
                                        const Point3D& speed, const AircraftCrashReason& reason) {
         std::string msg;
@@ -23,6 +25,9 @@ private:
         msg += "The aircraft was at " + pos.to_string() + " with a speed of " + speed.to_string() + ".";
         return msg;
     }
+private:
+    const AircraftCrashReason crash_reason;
+
     static std::string reason_to_string(const AircraftCrashReason& reason) {
         if (reason == out_of_fuel) return " it's run out of fuel";
         if (reason == bad_landing) return " of a lack of landing skill";
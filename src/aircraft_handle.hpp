@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+// Reference to an aircraft of the AircraftManager: a slot of its pool and the generation of the
+// flight using it. The handle goes stale once that flight is retired, even if the slot is reused.
+struct AircraftHandle
+{
+    static constexpr std::uint32_t NO_SLOT = std::numeric_limits<std::uint32_t>::max();
+
+    std::uint32_t slot       = NO_SLOT;
+    std::uint32_t generation = 0;
+
+    [[nodiscard]] bool empty() const { return slot == NO_SLOT; }
+    bool operator==(const AircraftHandle& other) const
+    {
+        return slot == other.slot && generation == other.generation;
+    }
+    bool operator!=(const AircraftHandle& other) const { return !(*this == other); }
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "GL/atlas.hpp"
+#include "aircraft_types.hpp"
+#include "img/image.hpp"
+#include "img/media_path.hpp"
+
+#include <cassert>
+#include <memory>
+#include <vector>
+
+namespace GL {
+
+// regions of the aircraft sprite sheets in the atlas, indexed by AircraftTypeId
+inline std::vector<const AtlasRegion*> aircraft_sprites;
+
+inline void register_aircraft_sprite([[maybe_unused]] const AircraftTypeId id, const MediaPath& sprite,
+                                                      const size_t num_tiles = NUM_AIRCRAFT_TILES)
+{
+    assert(id == aircraft_sprites.size());
+    aircraft_sprites.emplace_back(&atlas.add(std::make_unique<const img::Image>(sprite.get_full_path()), num_tiles));
+}
+
+inline const AtlasRegion& get_aircraft_sprite(const AircraftTypeId id)
+{
+    assert(id < aircraft_sprites.size());
+    return *aircraft_sprites[id];
+}
+
+} // namespace GL
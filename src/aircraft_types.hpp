@@ -1,42 +1,46 @@
 #pragma once
 
-#include "GL/texture.hpp"
-#include "img/image.hpp"
-#include "img/media_path.hpp"
+#include "config.hpp"
 
-#include <array>
+#include <cassert>
+#include <cstdint>
+#include <vector>
 
-struct AircraftType
+using AircraftTypeId = std::uint16_t;
+
+// Flight parameters of an aircraft type (the sprites live in GL::aircraft_sprites)
+// Everything derived is computed once at load time, and two types fit in a cache line.
+struct alignas(32) AircraftType
 {
     const float fuel_consumption;
     const float max_ground_speed;
     const float max_air_speed;
-    const unsigned max_fuel;
     const float max_accel;
-    const GL::Texture2D texture;
+    const unsigned max_fuel;
+    const float min_fuel;           // consumption for MIN_FUEL_DURATION
 
-    AircraftType(const AircraftType&) = delete;
-    AircraftType& operator=(const AircraftType&) = delete;
-    ~AircraftType() = default;
     AircraftType(const float max_ground_speed_, const float max_air_speed_, const float max_accel_,
-                 const float fuel_consumption_, const unsigned max_fuel_, const MediaPath& sprite,
-                 const size_t num_tiles = NUM_AIRCRAFT_TILES) :
+                 const float fuel_consumption_, const unsigned max_fuel_) :
         fuel_consumption { fuel_consumption_ },
         max_ground_speed { max_ground_speed_ },
         max_air_speed { max_air_speed_ },
-        max_fuel { max_fuel_ },
         max_accel { max_accel_ },
-        texture { new img::Image { sprite.get_full_path() }, num_tiles }
+        max_fuel { max_fuel_ },
+        min_fuel { fuel_consumption_ * MIN_FUEL_DURATION }
     {
         assert(fuel_consumption > 0);
         assert(max_ground_speed > 0);
         assert(max_air_speed > 0);
-        assert(max_fuel > min_fuel());
+        assert(max_fuel > min_fuel);
         assert(max_accel > 0);
     }
+};
 
-    [[nodiscard]] float min_fuel() const {
-        //        consumption for 10      seconds
-        return fuel_consumption * 10 * (float)GL::ticks_per_sec;
-    }
-};
\ No newline at end of file
+// table of the loaded types, indexed by AircraftTypeId (filled once by the AircraftFactory)
+inline std::vector<AircraftType> aircraft_types;
+
+inline const AircraftType& get_aircraft_type(const AircraftTypeId id)
+{
+    assert(id < aircraft_types.size());
+    return aircraft_types[id];
+}
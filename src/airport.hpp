@@ -1,30 +1,33 @@
 #pragma once
 
-#include "GL/dynamic_object.hpp"
 #include "AircraftManager.hpp"
+#include "allocation.hpp"
+#include "event_scheduler.hpp"
 #include "GL/displayable.hpp"
 #include "airport_type.hpp"
-#include "GL/texture.hpp"
+#include "GL/atlas.hpp"
 #include "img/image.hpp"
 #include "geometry.hpp"
 #include "terminal.hpp"
 #include "runway.hpp"
 #include "tower.hpp"
 
+#include <numeric>
 #include <vector>
 
-class Airport : public GL::Displayable, public GL::DynamicObject
+class Airport : public GL::Displayable, public EventHandler
 {
 private:
     const AirportType& type;
     const Point3D pos;
-    const GL::Texture2D texture;
+    const GL::AtlasRegion& texture;
     std::vector<Terminal> terminals;
     AircraftManager& manager;
+    EventScheduler& scheduler;
     Tower tower;
     unsigned fuel_stock = 0;
-    unsigned ordered_fuel = 0;
-    double next_refill_time = 0;
+    unsigned ordered_fuel = 0;                  // Carried by the tanker(s) of the next tanker_arrival
+    std::vector<size_t> waiting_for_fuel;       // Terminals whose aircraft waits for the next delivery
 
     // reserve a terminal
     // if a terminal is free, return
@@ -54,18 +57,63 @@ private:
         return terminals.at(terminal_number);
     }
 
-    void refuel_all(double dt) {
-        assert(dt > 0);
-        if (next_refill_time <= 0) {
-            const auto old = ordered_fuel;
-            fuel_stock += ordered_fuel;
-            ordered_fuel = std::min(FUEL_TANKER, manager.get_required_fuel());
-            next_refill_time = FUEL_REFILL_FREQUENCY;
-            std::cout << "Received : " << old << " | Stock : " << fuel_stock << " | Ordered : " << ordered_fuel << std::endl;
-        } else {
-            next_refill_time -= dt;
+    // aircraft booked in the terminal, nullptr if none
+    Aircraft* get_aircraft(const size_t terminal_number) const {
+        assert(terminal_number < terminals.size());
+        return manager.get(terminals[terminal_number].get_aircraft());
+    }
+
+    // an aircraft arrived at its terminal: schedule the end of its service and refuel it if needed,
+    // or at the next delivery if the stock is too low
+    void start_service(const size_t terminal_number, const Aircraft& aircraft) {
+        get_terminal(terminal_number).start_service(aircraft);
+        scheduler.schedule(SERVICE_CYCLES, EventKind::service_complete, *this, terminal_number);
+        if (refuel(terminal_number)) waiting_for_fuel.emplace_back(terminal_number);
+    }
+
+    // pump what the stock allows and return whether the aircraft still needs fuel
+    bool refuel(const size_t terminal_number) {
+        Terminal& terminal     = get_terminal(terminal_number);
+        Aircraft* aircraft     = get_aircraft(terminal_number);
+        if (aircraft == nullptr) return false;
+        const unsigned before  = fuel_stock;
+        const bool still_needs = terminal.refill_aircraft_if_needed(*aircraft, fuel_stock);
+        if (fuel_stock < before) {
+            terminal.start_refuel();
+            scheduler.schedule((before - fuel_stock) / REFUEL_RATE, EventKind::refuel_complete, *this, terminal_number);
         }
-        std::for_each(terminals.begin(), terminals.end(), [this](Terminal& t){t.refill_aircraft_if_needed(fuel_stock);});
+        return still_needs;
+    }
+
+    // the aircraft may leave once its service and refuel are complete
+    void try_release(const size_t terminal_number) {
+        const Terminal& terminal = get_terminal(terminal_number);
+        if (terminal.in_use() && !terminal.is_servicing())
+            scheduler.schedule(DEPARTURE_CLEARANCE_DELAY, EventKind::departure_release, *this, terminal_number);
+    }
+
+    // size the next order with the forecast of the fleet demand (whole tankers only)
+    unsigned order_size() const {
+        const unsigned waiting = std::accumulate(waiting_for_fuel.begin(), waiting_for_fuel.end(), 0u,
+                [this](unsigned x, size_t t){
+                    const Aircraft* aircraft = get_aircraft(t);
+                    return aircraft == nullptr ? x : x + aircraft->get_missing_fuel();
+                });
+        const unsigned demand = waiting + manager.forecast_fuel_demand(FUEL_FORECAST_HORIZON);
+        if (demand <= fuel_stock) return 0;
+        const unsigned tankers = (demand - fuel_stock + FUEL_TANKER - 1) / FUEL_TANKER;
+        return std::min(tankers, MAX_TANKERS_PER_ORDER) * FUEL_TANKER;
+    }
+
+    // tanker arrival: serve the waiting aircraft (first come, first served) and order the next delivery
+    void receive_fuel() {
+        const auto received = ordered_fuel;
+        fuel_stock += ordered_fuel;
+        waiting_for_fuel.erase(std::remove_if(waiting_for_fuel.begin(), waiting_for_fuel.end(),
+                [this](size_t t){ return !refuel(t); }), waiting_for_fuel.end());
+        ordered_fuel = order_size();
+        scheduler.schedule(FUEL_REFILL_FREQUENCY, EventKind::tanker_arrival, *this);
+        std::cout << "Received : " << received << " | Stock : " << fuel_stock << " | Ordered : " << ordered_fuel << '\n';
     }
 
 public:
@@ -73,31 +121,53 @@ public:
     Airport(const Airport&) = delete;
     Airport& operator=(const Airport&) = delete;
     Airport(const AirportType& type_, const Point3D& pos_, const img::Image* image, AircraftManager& _manager,
-            const float z_ = 1.0f) :
+            EventScheduler& scheduler_, const float z_ = 1.0f) :
         GL::Displayable { z_ },
         type { type_ },
         pos { pos_ },
-        texture { image },
+        texture { GL::atlas.add(std::unique_ptr<const img::Image> { image }) },
         terminals { type.create_terminals() },
         manager {_manager},
+        scheduler { scheduler_ },
         tower { *this }
-    {}
+    {
+        waiting_for_fuel.reserve(terminals.size());
+        manager.get_lifecycle_bus().subscribe(tower);
+        scheduler.schedule(0, EventKind::tanker_arrival, *this);   // First order
+    }
 
     Tower& get_tower() { return tower; }
+    [[nodiscard]] size_t count_free_terminals() const
+    {
+        return std::count_if(terminals.begin(), terminals.end(), [](const Terminal& t) { return !t.in_use(); });
+    }
 
-    void display() const override { texture.draw(project_2D(pos), { 2.0f, 2.0f }); }
+    void display(GL::Snapshot& frame) const override { frame.add_sprite(texture, project_2D(pos), { 2.0f, 2.0f }); }
 
-    void move(double dt) override
+    void on_event(const EventKind kind, const size_t target) override
     {
-        assert(dt);
-        std::for_each(terminals.begin(), terminals.end(), [dt](Terminal& t){t.move(dt);});
-        refuel_all(dt);
+        switch (kind) {
+            case EventKind::service_complete:
+                get_terminal(target).end_service();
+                try_release(target);
+                break;
+            case EventKind::refuel_complete:
+                get_terminal(target).end_refuel();
+                try_release(target);
+                break;
+            case EventKind::departure_release:
+                tower.release_aircraft(target);
+                break;
+            case EventKind::tanker_arrival:
+                receive_fuel();
+                break;
+        }
     }
 
-    void on_aircraft_crash(const Aircraft& aircraft) {
-        for (auto& terminal : terminals) {
-            terminal.on_aircraft_crash(aircraft);
-        }
+    void on_aircraft_crash(const size_t terminal_number) {
+        get_terminal(terminal_number).free();
+        waiting_for_fuel.erase(std::remove(waiting_for_fuel.begin(), waiting_for_fuel.end(), terminal_number),
+                               waiting_for_fuel.end());
     }
 
     friend class Tower;
@@ -0,0 +1,129 @@
+#include "allocation.hpp"
+
+#include "config.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+namespace alloc {
+
+namespace {
+
+constexpr auto PHASE_COUNT = static_cast<size_t>(Phase::count);
+
+thread_local Phase current_phase = Phase::idle;
+std::array<std::atomic<size_t>, PHASE_COUNT> tick_counters {};
+std::array<std::atomic<size_t>, PHASE_COUNT> total_counters {};
+bool steady_tick = true;
+
+alignas(std::max_align_t) std::array<std::byte, TICK_ARENA_SIZE> arena_buffer;
+std::pmr::monotonic_buffer_resource arena { arena_buffer.data(), arena_buffer.size() };
+
+constexpr std::array<const char*, PHASE_COUNT> phase_names { "idle", "traffic", "aircraft", "airport", "display" };
+
+void count_allocation()
+{
+    const auto idx = static_cast<size_t>(current_phase);
+    tick_counters[idx].fetch_add(1, std::memory_order_relaxed);
+    total_counters[idx].fetch_add(1, std::memory_order_relaxed);
+}
+
+void* allocate(const size_t size)
+{
+    count_allocation();
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) return ptr;
+    throw std::bad_alloc {};
+}
+
+void* allocate(const size_t size, const std::align_val_t align)
+{
+    count_allocation();
+    const auto alignment = static_cast<size_t>(align);
+    // aligned_alloc needs a size multiple of the alignment
+    if (void* ptr = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment)) return ptr;
+    throw std::bad_alloc {};
+}
+
+} // namespace
+
+PhaseGuard::PhaseGuard(const Phase phase) : previous { current_phase }
+{
+    current_phase = phase;
+}
+
+PhaseGuard::~PhaseGuard()
+{
+    current_phase = previous;
+}
+
+size_t tick_count(const Phase phase)
+{
+    return tick_counters[static_cast<size_t>(phase)].load(std::memory_order_relaxed);
+}
+
+size_t total_count(const Phase phase)
+{
+    return total_counters[static_cast<size_t>(phase)].load(std::memory_order_relaxed);
+}
+
+void begin_tick()
+{
+    for (auto& counter : tick_counters) counter.store(0, std::memory_order_relaxed);
+    arena.release();
+    steady_tick = true;
+}
+
+void end_tick()
+{
+    if (!ALLOCATION_CHECK || !steady_tick) return;
+    for (size_t i = 0; i < PHASE_COUNT; i++) {
+        const auto count = tick_counters[i].load(std::memory_order_relaxed);
+        if (i != static_cast<size_t>(Phase::display) && count > 0) {
+            std::cerr << count << " allocation(s) during the " << phase_names[i] << " phase of a steady tick\n";
+            assert(false && "steady-state ticks must not allocate");
+        }
+    }
+}
+
+void mark_unsteady()
+{
+    steady_tick = false;
+}
+
+std::pmr::memory_resource& tick_arena()
+{
+    return arena;
+}
+
+void display_counters()
+{
+    std::cout << "Allocations (last tick / total):\n";
+    for (size_t i = 0; i < PHASE_COUNT; i++) {
+        std::cout << "  " << phase_names[i] << " : " << tick_counters[i] << " / " << total_counters[i] << '\n';
+    }
+    std::cout << std::flush;
+}
+
+} // namespace alloc
+
+void* operator new(const size_t size) { return alloc::allocate(size); }
+void* operator new[](const size_t size) { return alloc::allocate(size); }
+void* operator new(const size_t size, const std::align_val_t align) { return alloc::allocate(size, align); }
+void* operator new[](const size_t size, const std::align_val_t align) { return alloc::allocate(size, align); }
+void* operator new(const size_t size, const std::nothrow_t&) noexcept {
+    try { return alloc::allocate(size); } catch (const std::bad_alloc&) { return nullptr; }
+}
+void* operator new[](const size_t size, const std::nothrow_t&) noexcept {
+    try { return alloc::allocate(size); } catch (const std::bad_alloc&) { return nullptr; }
+}
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept { std::free(ptr); }
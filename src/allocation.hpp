@@ -0,0 +1,41 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+
+// Heap allocation accounting
+// The global operator new is replaced (see allocation.cpp) so that every allocation is counted in the
+// phase of the tick that is currently running.
+namespace alloc {
+
+enum class Phase { idle, traffic, aircraft, airport, display, count };
+
+// set the phase of the current thread for the lifetime of the guard
+class PhaseGuard
+{
+public:
+    explicit PhaseGuard(Phase phase);
+    ~PhaseGuard();
+    PhaseGuard(const PhaseGuard&) = delete;
+    PhaseGuard& operator=(const PhaseGuard&) = delete;
+private:
+    const Phase previous;
+};
+
+// number of allocations of the phase during the last tick and since the start
+[[nodiscard]] size_t tick_count(Phase phase);
+[[nodiscard]] size_t total_count(Phase phase);
+
+// called around each tick: resets the tick counters and the tick arena, then checks the tick
+void begin_tick();
+void end_tick();
+// the current tick is not a steady-state one (pool growth, crash...), its allocations are expected
+void mark_unsteady();
+
+// monotonic buffer for the scratch space of a tick (released at the start of each tick)
+std::pmr::memory_resource& tick_arena();
+
+void display_counters();
+
+} // namespace alloc
@@ -0,0 +1,67 @@
+#include "arrival_scheduler.hpp"
+
+#include "aircraft.hpp"
+
+void ArrivalScheduler::place(const size_t idx, Entry entry)
+{
+    entry.aircraft->arrival_slot = idx;
+    heap[idx] = entry;
+}
+
+void ArrivalScheduler::sift_up(size_t idx)
+{
+    const Entry entry = heap[idx];
+    while (idx > 0) {
+        const size_t parent = (idx - 1) / 2;
+        if (!(entry < heap[parent])) break;
+        place(idx, heap[parent]);
+        idx = parent;
+    }
+    place(idx, entry);
+}
+
+void ArrivalScheduler::sift_down(size_t idx)
+{
+    const Entry entry = heap[idx];
+    while (true) {
+        size_t child = 2 * idx + 1;
+        if (child >= heap.size()) break;
+        if (child + 1 < heap.size() && heap[child + 1] < heap[child]) child++;
+        if (!(heap[child] < entry)) break;
+        place(idx, heap[child]);
+        idx = child;
+    }
+    place(idx, entry);
+}
+
+void ArrivalScheduler::push(Aircraft& aircraft, const double deadline)
+{
+    assert(aircraft.arrival_slot == NOT_WAITING);
+    if (heap.size() == heap.capacity()) alloc::mark_unsteady();
+    heap.emplace_back(Entry { deadline, next_seq++, &aircraft });
+    sift_up(heap.size() - 1);
+}
+
+void ArrivalScheduler::update(Aircraft& aircraft, const double deadline)
+{
+    const size_t idx = aircraft.arrival_slot;
+    assert(idx < heap.size() && heap[idx].aircraft == &aircraft);
+    const double old = heap[idx].deadline;
+    heap[idx].deadline = deadline;
+    if (deadline < old) sift_up(idx);
+    else sift_down(idx);
+}
+
+void ArrivalScheduler::remove(Aircraft& aircraft)
+{
+    const size_t idx = aircraft.arrival_slot;
+    assert(idx < heap.size() && heap[idx].aircraft == &aircraft);
+    aircraft.arrival_slot = NOT_WAITING;
+    const Entry last = heap.back();
+    heap.pop_back();
+    if (idx == heap.size()) return;                         // The removed entry was the last one
+    heap[idx] = last;
+    last.aircraft->arrival_slot = idx;
+    if (idx > 0 && last < heap[(idx - 1) / 2]) sift_up(idx);
+    else sift_down(idx);
+}
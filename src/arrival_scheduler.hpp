@@ -0,0 +1,47 @@
+#pragma once
+
+#include "allocation.hpp"
+
+#include <cassert>
+#include <limits>
+#include <utility>
+#include <vector>
+
+class Aircraft;
+
+// Indexed binary min-heap of the aircraft waiting for a terminal, ordered by deadline (earliest first).
+// Each aircraft stores its position in the heap (Aircraft::arrival_slot), so a deadline can be updated
+// or an aircraft removed in O(log n).
+class ArrivalScheduler
+{
+public:
+    static constexpr size_t NOT_WAITING = std::numeric_limits<size_t>::max();
+
+    [[nodiscard]] bool empty() const { return heap.empty(); }
+    [[nodiscard]] size_t size() const { return heap.size(); }
+    [[nodiscard]] Aircraft& top() const { assert(!empty()); return *heap.front().aircraft; }
+
+    void push(Aircraft& aircraft, double deadline);
+    void update(Aircraft& aircraft, double deadline);
+    void remove(Aircraft& aircraft);
+    void pop() { remove(top()); }
+
+private:
+    struct Entry
+    {
+        double deadline;
+        unsigned long seq;          // Equal deadlines are served in arrival order
+        Aircraft* aircraft;
+
+        bool operator<(const Entry& other) const {
+            return deadline == other.deadline ? seq < other.seq : deadline < other.deadline;
+        }
+    };
+
+    std::vector<Entry> heap;
+    unsigned long next_seq = 0;
+
+    void place(size_t idx, Entry entry);
+    void sift_up(size_t idx);
+    void sift_down(size_t idx);
+};
@@ -2,6 +2,7 @@
 
 #include "img/media_path.hpp"
 
+#include <array>
 #include <stdexcept>
 
 const MediaPath one_lane_airport_sprite_path = { "airport_1lane.png" };
@@ -9,21 +10,96 @@ const MediaPath one_lane_airport_sprite_path = { "airport_1lane.png" };
 
 // number of cycles needed to service an aircraft at a terminal
 constexpr unsigned int SERVICE_CYCLES = 40u;
+// fuel pumped into an aircraft per unit of time
+constexpr double REFUEL_RATE = 200.;
+// delay between the end of the service and the departure clearance
+constexpr double DEPARTURE_CLEARANCE_DELAY = 1.;
+// initial capacity of the event queue
+constexpr size_t EVENT_QUEUE_CAPACITY = 256;
+// initial capacity of the per-tick buffer of aircraft lifecycle events
+constexpr size_t LIFECYCLE_BUFFER_CAPACITY = 256;
 // speeds below the threshold speed loose altitude linearly
 constexpr float SPEED_THRESHOLD = 0.05f;
 // this models the speed with which slow (speed < SPEED_THRESHOLD) aircrafts sink
 constexpr float SINK_FACTOR = 0.1f;
+// aircraft closer than this distance to the airport can be given a terminal
+constexpr float AIRPORT_AREA_RADIUS = 5.f;
 // distances below this distance are considered equal (planes crash, waypoints
 // are reached, etc)
 constexpr float DISTANCE_THRESHOLD = 0.05f;
+// time step for which the turn and sink rates are given (one tick at the default rates)
+constexpr double RATE_TIME_STEP = 0.55;
+// longest time step an aircraft integrates at once on a straight leg (a coarse update, see INBOUND_UPDATE_PERIOD)
+constexpr double MAX_SUBSTEP = 4 * RATE_TIME_STEP;
+// an aircraft heading within this cosine of its target flies a straight leg
+constexpr float STRAIGHT_LEG_COS = 0.9995f;
+// longest distance flown in a single substep
+constexpr float MAX_SUBSTEP_DISTANCE = 2 * DISTANCE_THRESHOLD;
 // each aircraft sprite has 8 tiles
 constexpr unsigned char NUM_AIRCRAFT_TILES = 8;
+// sprite atlas: mip levels sampled, padding around each sheet (enough for these levels) and largest side
+constexpr int ATLAS_MIP_LEVELS      = 3;
+constexpr unsigned int ATLAS_PADDING = 1u << ATLAS_MIP_LEVELS;
+constexpr unsigned int ATLAS_MAX_SIZE = 8192u;
+// positions kept in an aircraft trail and minimal distance between two of them (on screen)
+constexpr unsigned int TRAIL_LENGTH = 32u;
+constexpr float TRAIL_SPACING       = 0.05f;
+constexpr float TRAIL_ALPHA         = 0.4f;
+// traffic density overlay: cells per side, half-size on screen, fading time, opacity and snapshots
+// between two uploads of the overlay
+constexpr unsigned int HEATMAP_DIM  = 128u;
+constexpr float HEATMAP_EXTENT      = 8.f;
+constexpr double HEATMAP_DECAY_TIME = 200.;
+constexpr float HEATMAP_MAX_SCALE   = 1e20f;      // the cells are renormalized beyond it
+constexpr float HEATMAP_ALPHA       = 0.6f;
+constexpr unsigned int HEATMAP_UPLOAD_PERIOD = 10u;
+// flight data labels, laid out in window pixels whatever the zoom: pixels per font pixel, characters
+// per line, offset from the aircraft
+constexpr float LABEL_GLYPH_SCALE    = 2.f;
+constexpr unsigned int LABEL_LINE_LENGTH = 9u;
+constexpr float LABEL_OFFSET_X       = 16.f;
+constexpr float LABEL_OFFSET_Y       = 12.f;
+// decluttering: most labels in a frame, grid of accepted labels in pixels (a cell is larger than a label)
+constexpr unsigned int MAX_LABELS    = 256u;
+constexpr unsigned int LABEL_GRID_DIM = 64u;
+constexpr float LABEL_CELL_WIDTH     = 112.f;
+constexpr float LABEL_CELL_HEIGHT    = 32.f;
+// performance HUD: samples kept per graph, pixels per font pixel, file written by the dump keystroke
+constexpr size_t HUD_HISTORY         = 120;
+constexpr float HUD_GLYPH_SCALE      = 2.f;
+constexpr const char* HUD_DUMP_FILE  = "perf_hud.csv";
+// headless capture: size of the frames, default ticks between two frames and default length of the run
+constexpr unsigned int CAPTURE_WIDTH  = 800u;
+constexpr unsigned int CAPTURE_HEIGHT = 600u;
+constexpr unsigned int CAPTURE_EVERY  = 4u;
+constexpr unsigned long CAPTURE_TICKS = 6'000ul;
+// render benchmark: default aircraft counts, zoom levels, frames measured per case, half-size of the scene
+constexpr std::array<size_t, 3> BENCH_COUNTS = { 1'000, 10'000, 100'000 };
+constexpr std::array<float, 3> BENCH_ZOOMS   = { .5f, 2.f, 8.f };
+constexpr unsigned int BENCH_FRAMES          = 50u;
+constexpr float BENCH_EXTENT                 = 8.f;
 // size of the plane-sprite on screen
 constexpr float PLANE_TEXTURE_DIM = 0.2f;
 // default number of ticks per second
 constexpr unsigned int DEFAULT_TICKS_PER_SEC = 30u;
+// simulated time per real millisecond, and how far it can be accelerated
+constexpr double DEFAULT_FRAMERATE_MODIFIER = 0.0167;
+constexpr double MAX_TIME_SCALE             = 1000.;
+// frames drawn per second by the render thread (independent of the simulation's ticks)
+constexpr unsigned int DISPLAY_FRAMES_PER_SEC = 60u;
+// late iterations (in periods) tolerated before the pacing restarts from now
+constexpr unsigned int MAX_PACING_LAG = 5u;
+// snapshots skipped in a row when the simulation cannot keep up
+constexpr unsigned int MAX_SKIPPED_SNAPSHOTS = 4u;
 // default zoom factor
 constexpr float DEFAULT_ZOOM = 2.0f;
+// fraction of the view moved by one pan step
+constexpr float CAMERA_PAN_STEP = 0.1f;
+// culling grid over the screen plane: cells per side and cell size
+constexpr unsigned int DISPLAY_GRID_DIM = 64u;
+constexpr float DISPLAY_GRID_CELL       = 0.5f;
+// extra border around the view when culling (half the size of a sprite plus the motion of a tick)
+constexpr float CULL_MARGIN = 0.5f;
 // default window dimensions
 constexpr size_t DEFAULT_WINDOW_WIDTH  = 800;
 constexpr size_t DEFAULT_WINDOW_HEIGHT = 600;
@@ -32,6 +108,41 @@ constexpr bool SILENT_TERMINAL = false;
 // Fuel data
 constexpr unsigned FUEL_TANKER = 5'000;
 constexpr unsigned FUEL_REFILL_FREQUENCY = 100;
+// an order is delivered one period later and must last one more period
+constexpr double FUEL_FORECAST_HORIZON = 2. * FUEL_REFILL_FREQUENCY;
+constexpr unsigned MAX_TANKERS_PER_ORDER = 4;
+// an aircraft is low on fuel below the consumption of this duration (10 seconds at the default tick rate)
+constexpr float MIN_FUEL_DURATION = 10.f * DEFAULT_TICKS_PER_SEC;
+// Traffic data
+// mean number of arrivals per unit of time
+constexpr double DEFAULT_ARRIVAL_RATE = 0.05;
+// arrival rate multipliers and mean durations of the bursty process states
+constexpr double BURST_RATE_FACTOR   = 6.;
+constexpr double CALM_RATE_FACTOR    = 0.2;
+constexpr double MEAN_BURST_DURATION = 30.;
+constexpr double MEAN_CALM_DURATION  = 150.;
+// duration of a simulated day and arrival rate multiplier for each of its hours
+constexpr double DAY_DURATION = 2'400.;
+constexpr std::array<double, 24> HOURLY_TRAFFIC_PROFILE = {
+    .1, .05, .05, .05, .1, .3, .8, 1.5, 1.8, 1.4, 1., .9, 1., 1.1, 1., 1., 1.2, 1.6, 1.8, 1.4, .9, .6, .3, .2
+};
+// live aircraft counts sustained by the stress mode (0 disables it)
+constexpr std::array<size_t, 4> STRESS_LEVELS = { 0, 10'000, 100'000, 1'000'000 };
+// maximum number of aircraft created in a single tick by the stress mode
+constexpr size_t MAX_STRESS_BATCH = 100'000;
+// update period (in ticks) of the traffic generator (the event scheduler moves every tick: its clock
+// drives the holding aircraft and an idle tick only checks the top of the queue)
+constexpr unsigned TRAFFIC_UPDATE_PERIOD = 4;
+// update period of the airborne aircraft far from their next waypoint and not cleared to land
+constexpr unsigned INBOUND_UPDATE_PERIOD = 4;
+// size of the scratch buffer available during each tick
+constexpr size_t TICK_ARENA_SIZE = 256 * 1024;
+// report (and assert on) heap allocations during steady-state ticks
+#ifdef NDEBUG
+constexpr bool ALLOCATION_CHECK = false;
+#else
+constexpr bool ALLOCATION_CHECK = true;
+#endif
 
 
 
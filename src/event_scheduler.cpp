@@ -0,0 +1,35 @@
+#include "event_scheduler.hpp"
+
+#include "allocation.hpp"
+#include "config.hpp"
+#include "GL/perf_hud.hpp"
+
+#include <cassert>
+
+EventScheduler::EventScheduler()
+{
+    std::vector<Event> storage;
+    storage.reserve(EVENT_QUEUE_CAPACITY);
+    events = decltype(events) { std::greater<> {}, std::move(storage) };
+    GL::move_queue.emplace(this);
+}
+
+void EventScheduler::schedule(const double delay, const EventKind kind, EventHandler& handler, const size_t target)
+{
+    assert(delay >= 0);
+    if (events.size() >= EVENT_QUEUE_CAPACITY) alloc::mark_unsteady();  // The queue may grow
+    events.push(Event { clock + delay, next_seq++, kind, &handler, target });
+}
+
+void EventScheduler::move(const double dt)
+{
+    assert(dt > 0);
+    const alloc::PhaseGuard phase { alloc::Phase::airport };
+    const GL::StageTimer timer { GL::Stage::airport };
+    clock += dt;
+    while (!events.empty() && events.top().time <= clock) {
+        const Event event = events.top();
+        events.pop();
+        event.handler->on_event(event.kind, event.target);     // May schedule new events
+    }
+}
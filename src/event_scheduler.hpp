@@ -0,0 +1,56 @@
+#pragma once
+
+#include "GL/dynamic_object.hpp"
+#include "config.hpp"
+
+#include <functional>
+#include <limits>
+#include <queue>
+#include <vector>
+
+enum class EventKind { service_complete, refuel_complete, departure_release, tanker_arrival };
+
+// Receives the events it scheduled, `target` identifying the concerned entity (ex: a terminal number)
+class EventHandler
+{
+public:
+    virtual ~EventHandler() = default;
+    virtual void on_event(EventKind kind, size_t target) = 0;
+};
+
+// Discrete-event core: timed events are kept in a priority queue and dispatched once the simulation
+// clock reaches them, so entities that are just waiting cost nothing per tick.
+class EventScheduler : public GL::DynamicObject
+{
+public:
+    EventScheduler();
+    ~EventScheduler() override = default;
+    EventScheduler(const EventScheduler&) = delete;
+    EventScheduler& operator=(const EventScheduler&) = delete;
+
+    void schedule(double delay, EventKind kind, EventHandler& handler, size_t target = 0);
+    void move(double dt) override;
+
+    [[nodiscard]] double now() const { return clock; }
+    // time left before the next event (infinity if there is none)
+    [[nodiscard]] double time_to_next_event() const {
+        return events.empty() ? std::numeric_limits<double>::infinity() : events.top().time - clock;
+    }
+private:
+    struct Event
+    {
+        double time;
+        unsigned long seq;          // Events due at the same time are dispatched in scheduling order
+        EventKind kind;
+        EventHandler* handler;
+        size_t target;
+
+        bool operator>(const Event& other) const {
+            return time == other.time ? seq > other.seq : time > other.time;
+        }
+    };
+
+    std::priority_queue<Event, std::vector<Event>, std::greater<>> events;
+    double clock           = 0;
+    unsigned long next_seq = 0;
+};
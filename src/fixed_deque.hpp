@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <utility>
+
+// Double-ended queue with a fixed capacity stored inline (a ring buffer)
+// Unlike std::deque, it never allocates, so copying or clearing it is cheap and its storage is reused.
+template<typename T, size_t Capacity>
+class FixedDeque
+{
+static_assert(Capacity > 0);
+public:
+    template<bool Const>
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = T;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = std::conditional_t<Const, const T*, T*>;
+        using reference         = std::conditional_t<Const, const T&, T&>;
+        using container         = std::conditional_t<Const, const FixedDeque, FixedDeque>;
+
+        Iterator(container& queue_, const size_t idx_) : queue { &queue_ }, idx { idx_ } {}
+
+        reference operator*() const { return (*queue)[idx]; }
+        pointer operator->() const { return &(*queue)[idx]; }
+        Iterator& operator++() { ++idx; return *this; }
+        Iterator operator++(int) { auto old = *this; ++idx; return old; }
+        bool operator==(const Iterator& other) const { return queue == other.queue && idx == other.idx; }
+        bool operator!=(const Iterator& other) const { return !(*this == other); }
+    private:
+        container* queue;
+        size_t idx;
+    };
+    using iterator       = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    FixedDeque() = default;
+    FixedDeque(std::initializer_list<T> values) {
+        for (const auto& v : values) push_back(v);
+    }
+
+    [[nodiscard]] size_t size() const { return count; }
+    [[nodiscard]] bool empty() const { return count == 0; }
+    [[nodiscard]] static constexpr size_t capacity() { return Capacity; }
+    void clear() { first = 0; count = 0; }
+
+    T& operator[](const size_t i) { assert(i < count); return data[(first + i) % Capacity]; }
+    const T& operator[](const size_t i) const { assert(i < count); return data[(first + i) % Capacity]; }
+    T& front() { return (*this)[0]; }
+    const T& front() const { return (*this)[0]; }
+    T& back() { return (*this)[count - 1]; }
+    const T& back() const { return (*this)[count - 1]; }
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_front(const T& value) { emplace_front(value); }
+
+    template<typename ... Args>
+    T& emplace_back(Args&& ... args) {
+        assert(count < Capacity);
+        T& slot = data[(first + count++) % Capacity];
+        slot = T { std::forward<Args>(args)... };
+        return slot;
+    }
+    template<typename ... Args>
+    T& emplace_front(Args&& ... args) {
+        assert(count < Capacity);
+        first = (first + Capacity - 1) % Capacity;
+        ++count;
+        data[first] = T { std::forward<Args>(args)... };
+        return data[first];
+    }
+    void pop_front() {
+        assert(count > 0);
+        first = (first + 1) % Capacity;
+        --count;
+    }
+
+    iterator begin() { return { *this, 0 }; }
+    iterator end() { return { *this, count }; }
+    const_iterator begin() const { return { *this, 0 }; }
+    const_iterator end() const { return { *this, count }; }
+private:
+    std::array<T, Capacity> data {};
+    size_t first = 0;
+    size_t count = 0;
+};
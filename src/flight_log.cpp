@@ -0,0 +1,22 @@
+#include "flight_log.hpp"
+
+#include "aircraft.hpp"
+
+#include <iostream>
+
+void FlightLog::on_lifecycle_events(const std::vector<LifecycleEvent>& events)
+{
+    for (const auto& event: events) {
+        if (event.kind == LifecycleKind::crashed) {
+            crash_count++;
+            std::cerr << event.aircraft->crash_report() << std::endl;
+        } else if (event.kind == LifecycleKind::departed) {
+            departure_count++;
+        }
+    }
+}
+
+void FlightLog::display_counts() const
+{
+    std::cout << crash_count << " aircraft(s) have crashed so far, " << departure_count << " departed." << std::endl;
+}
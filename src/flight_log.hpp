@@ -0,0 +1,16 @@
+#pragma once
+
+#include "lifecycle_bus.hpp"
+
+// Lifecycle subscriber reporting the crashes as they are dispatched, and counting the crashes and
+// the departures for the 'm' keystroke
+class FlightLog : public LifecycleSubscriber
+{
+public:
+    void on_lifecycle_events(const std::vector<LifecycleEvent>& events) override;
+    void display_counts() const;
+
+private:
+    unsigned crash_count     = 0;
+    unsigned departure_count = 0;
+};
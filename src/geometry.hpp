@@ -25,6 +25,7 @@ public:
     Point(Point&& other) : values {other.values} {}
     Point(const Point& other) : values {other.values} {}
     Point(const Point&& other) : values {other.values} {}
+    Point& operator=(const Point& other) = default;
 
     template<typename ... U, typename = Arithmetic<U...>>
     Point(U&& ... val) : values {std::forward<U>(val)...} {
@@ -115,6 +116,11 @@ public:
 
     T distance_to(const Point& other) const { return (*this - other).length(); }
 
+    T dot(const Point& other) const
+    {
+        return std::inner_product(values.begin(), values.end(), other.values.begin(), static_cast<T>(0));
+    }
+
     Point& normalize(const T target_len = 1.0f)
     {
         const T current_len = length();
@@ -156,4 +162,12 @@ inline Point2D project_2D(const Point3D& p)
     return { .5f * p.x() - .5f * p.y(), .5f * p.x() + .5f * p.y() + p.z() };
 }
 
-
+// point of the segment [a, b] closest to p
+inline Point3D closest_on_segment(const Point3D& p, const Point3D& a, const Point3D& b)
+{
+    const Point3D ab  = b - a;
+    const float len2  = ab.dot(ab);
+    if (len2 == 0) return a;
+    const float t = std::clamp((p - a).dot(ab) / len2, 0.f, 1.f);
+    return a + ab * t;
+}
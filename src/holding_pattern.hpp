@@ -0,0 +1,67 @@
+#pragma once
+
+#include "geometry.hpp"
+#include "waypoint.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+
+// Closed-form description of a holding lap: the closed polyline through the waypoints of the circle,
+// flown at constant speed. The position along the lap is its arc length (modulo the lap length).
+class HoldingPattern
+{
+public:
+    explicit HoldingPattern(const WaypointQueue& circle)
+    {
+        assert(circle.size() == NUM_CORNERS);
+        for (size_t i = 0; i < NUM_CORNERS; i++) corners[i] = circle[i];
+        for (size_t i = 0; i < NUM_CORNERS; i++) {
+            offsets[i] = lap_length;
+            lap_length += corners[i].distance_to(corners[(i + 1) % NUM_CORNERS]);
+        }
+    }
+
+    [[nodiscard]] float length() const { return lap_length; }
+
+    // arc length of the corner at `point` (the lap starts at the first corner)
+    [[nodiscard]] float offset_of(const Point3D& point) const
+    {
+        const auto it = std::min_element(corners.begin(), corners.end(),
+                [&point](const Point3D& a, const Point3D& b){ return a.distance_to(point) < b.distance_to(point); });
+        return offsets[std::distance(corners.begin(), it)];
+    }
+
+    [[nodiscard]] Point3D position(const float arc) const
+    {
+        const size_t seg = segment(arc);
+        const Point3D& from = corners[seg];
+        const Point3D& to   = corners[(seg + 1) % NUM_CORNERS];
+        const float ratio   = (wrap(arc) - offsets[seg]) / from.distance_to(to);
+        return from + (to - from) * ratio;
+    }
+
+    // unit vector of the direction of travel
+    [[nodiscard]] Point3D direction(const float arc) const
+    {
+        const size_t seg = segment(arc);
+        return (corners[(seg + 1) % NUM_CORNERS] - corners[seg]).normalize();
+    }
+
+private:
+    static constexpr size_t NUM_CORNERS = 4;
+
+    std::array<Point3D, NUM_CORNERS> corners;
+    std::array<float, NUM_CORNERS> offsets {};  // Arc length at each corner
+    float lap_length = 0;
+
+    [[nodiscard]] float wrap(const float arc) const { return std::fmod(arc, lap_length); }
+    [[nodiscard]] size_t segment(const float arc) const
+    {
+        const float s = wrap(arc);
+        size_t seg = NUM_CORNERS - 1;
+        while (seg > 0 && offsets[seg] > s) seg--;
+        return seg;
+    }
+};
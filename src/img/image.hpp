@@ -3,6 +3,9 @@
 #include "../config.hpp"
 #include "stb_image.h"
 
+#include <cstdlib>
+#include <cstring>
+
 #include <filesystem>
 #include <string>
 #include <vector>
@@ -30,6 +33,16 @@ public:
         pixel_size = static_cast<unsigned int>(p);
     }
 
+    // RGBA pixels generated in memory (freed like the ones loaded from a file)
+    Image(const unsigned int width_, const unsigned int height_, const std::vector<unsigned char>& rgba) :
+        data { static_cast<unsigned char*>(std::malloc(rgba.size())) },
+        width { width_ },
+        height { height_ },
+        pixel_size { 4u }
+    {
+        std::memcpy(data, rgba.data(), rgba.size());
+    }
+
     Image(const Image&) = delete;
     Image& operator=(const Image&) = delete;
 
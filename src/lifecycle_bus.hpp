@@ -0,0 +1,57 @@
+#pragma once
+
+#include "allocation.hpp"
+#include "config.hpp"
+
+#include <vector>
+
+class Aircraft;
+
+enum class LifecycleKind { arrived_at_terminal, departed, crashed };
+
+// The aircraft stays valid until the bus is dispatched: the AircraftManager releases the
+// departed and crashed aircraft only afterwards.
+struct LifecycleEvent
+{
+    LifecycleKind kind;
+    Aircraft* aircraft;
+};
+
+// Receives every lifecycle event of a tick at once
+class LifecycleSubscriber
+{
+public:
+    virtual ~LifecycleSubscriber() = default;
+    virtual void on_lifecycle_events(const std::vector<LifecycleEvent>& events) = 0;
+};
+
+// The aircraft kernels only append to the tick's buffer, the subscribers consume it in batch
+// when the AircraftManager dispatches it (once all the aircraft have moved).
+class LifecycleBus
+{
+public:
+    LifecycleBus() { buffer.reserve(LIFECYCLE_BUFFER_CAPACITY); }
+    LifecycleBus(const LifecycleBus&) = delete;
+    LifecycleBus& operator=(const LifecycleBus&) = delete;
+
+    void subscribe(LifecycleSubscriber& subscriber) { subscribers.emplace_back(&subscriber); }
+
+    void publish(const LifecycleKind kind, Aircraft& aircraft)
+    {
+        if (buffer.size() == buffer.capacity()) alloc::mark_unsteady();
+        buffer.push_back({ kind, &aircraft });
+    }
+
+    void dispatch()
+    {
+        if (buffer.empty()) return;
+        for (auto* subscriber: subscribers) {
+            subscriber->on_lifecycle_events(buffer);
+        }
+        buffer.clear();
+    }
+
+private:
+    std::vector<LifecycleEvent> buffer;
+    std::vector<LifecycleSubscriber*> subscribers;
+};
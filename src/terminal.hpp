@@ -1,16 +1,19 @@
 #pragma once
 
-#include "GL/dynamic_object.hpp"
 #include "aircraft.hpp"
 #include "geometry.hpp"
 
 #include <cassert>
 
-class Terminal : public GL::DynamicObject
+// The service and refuel durations are handled by the airport's EventScheduler:
+// a terminal only records what is still in progress.
+class Terminal
 {
 private:
-    double service_progress    = SERVICE_CYCLES;
-    Aircraft* booked_in_aircraft = nullptr;
+    bool servicing               = false;
+    bool needs_fuel              = false;   // the stock could not fill the aircraft up
+    unsigned pending_refuels     = 0;
+    AircraftHandle booked_in_aircraft = {};
     const Point3D pos;
 
 public:
@@ -18,44 +21,45 @@ public:
     Terminal& operator=(const Terminal&) = delete;
     explicit Terminal(const Point3D& pos_) : pos { pos_ } {}
 
-    [[nodiscard]] bool in_use() const { return booked_in_aircraft != nullptr; }
-    [[nodiscard]] bool is_servicing() const {
-        return service_progress < SERVICE_CYCLES
-        || (booked_in_aircraft != nullptr && booked_in_aircraft->is_low_on_fuel());
-    }
-    void assign_craft(Aircraft& aircraft) { booked_in_aircraft = &aircraft; }
+    [[nodiscard]] bool in_use() const { return !booked_in_aircraft.empty(); }
+    [[nodiscard]] bool is_servicing() const { return servicing || pending_refuels > 0 || needs_fuel; }
+    [[nodiscard]] AircraftHandle get_aircraft() const { return booked_in_aircraft; }
+    void assign_craft(const Aircraft& aircraft) { booked_in_aircraft = aircraft.get_handle(); }
 
     void start_service(const Aircraft& aircraft)
     {
         assert(aircraft.distance_to(pos) < DISTANCE_THRESHOLD);
         if (!SILENT_TERMINAL)
             std::cout << "now servicing " << aircraft.get_flight_num() << "...\n";
-        service_progress = 0;
+        servicing = true;
+    }
+    void end_service() { servicing = false; }
+    void start_refuel() { pending_refuels++; }
+    void end_refuel() {
+        if (pending_refuels > 0) pending_refuels--;
     }
 
-    void finish_service()
+    void finish_service(const Aircraft& aircraft)
     {
-        assert(booked_in_aircraft != nullptr);
+        assert(aircraft.get_handle() == booked_in_aircraft);
         if (is_servicing()) return;
-        if (!SILENT_TERMINAL) std::cout << "done servicing " << booked_in_aircraft->get_flight_num() << '\n';
-        booked_in_aircraft = nullptr;
+        if (!SILENT_TERMINAL) std::cout << "done servicing " << aircraft.get_flight_num() << '\n';
+        booked_in_aircraft = {};
     }
 
-    void refill_aircraft_if_needed(unsigned& fuel_stock) {
-        if (booked_in_aircraft != nullptr && booked_in_aircraft->is_low_on_fuel())
-            booked_in_aircraft->refill(fuel_stock);
+    // refill the booked aircraft if it is low on fuel and return whether it still needs fuel
+    bool refill_aircraft_if_needed(Aircraft& aircraft, unsigned& fuel_stock) {
+        assert(aircraft.get_handle() == booked_in_aircraft);
+        if (aircraft.is_low_on_fuel()) aircraft.refill(fuel_stock);
+        needs_fuel = aircraft.is_low_on_fuel();
+        return needs_fuel;
     }
 
-    void move(double dt) override
-    {
-        if (in_use() && is_servicing())
-        {
-            service_progress += dt;
-        }
-    }
-    void on_aircraft_crash(const Aircraft& aircraft) {
-        if (&aircraft == booked_in_aircraft) {
-            booked_in_aircraft = nullptr;
-        }
+    // the booked aircraft left without being released (crash)
+    void free() {
+        booked_in_aircraft = {};
+        servicing          = false;
+        needs_fuel         = false;
+        pending_refuels    = 0;
     }
-};
\ No newline at end of file
+};
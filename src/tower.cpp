@@ -5,59 +5,119 @@
 
 #include <cassert>
 
-WaypointQueue Tower::get_circle()
-{
-    return { Waypoint { Point3D { -1.5f, -1.5f, .5f }, wp_air },
-             Waypoint { Point3D { 1.5f, -1.5f, .5f }, wp_air },
-             Waypoint { Point3D { 1.5f, 1.5f, .5f }, wp_air },
-             Waypoint { Point3D { -1.5f, 1.5f, .5f }, wp_air } };
-}
-
-WaypointQueue Tower::get_instructions(Aircraft& aircraft)
-{
-    if (aircraft.is_at_terminal)                                                // If the aircraft is at terminal
-    {
-        const auto it = reserved_terminals.find(&aircraft);                     // Find the aircraft
-        assert(it != reserved_terminals.end());                                 // Ensure the aircraft is found
-        const auto terminal_num = it->second;                                   // Get the terminal number
-        Terminal& terminal      = airport.get_terminal(terminal_num);           // Get the terminal
-        if (terminal.is_servicing())                                            // If not done servicing
-            return {};
-        terminal.finish_service();                                              // Remove the aircraft from terminal
-        reserved_terminals.erase(it);                                           // Remove the terminal from reserved
-        aircraft.is_at_terminal = false;
-        return airport.start_path(terminal_num);                                // Create a path to let the aircraft fly
-    }
-    auto instr = instruction_aux(aircraft);
-    return instr.empty() ? get_circle() : instr;
+Tower::Tower(Airport& airport_) : airport { airport_ } {}
+
+const WaypointQueue& Tower::get_circle()
+{
+    static const WaypointQueue circle { Waypoint { Point3D { -1.5f, -1.5f, .5f }, wp_air },
+                                        Waypoint { Point3D { 1.5f, -1.5f, .5f }, wp_air },
+                                        Waypoint { Point3D { 1.5f, 1.5f, .5f }, wp_air },
+                                        Waypoint { Point3D { -1.5f, 1.5f, .5f }, wp_air } };
+    return circle;
+}
+
+const Point3D& Tower::get_position() const
+{
+    return airport.pos;
+}
+
+double Tower::now() const
+{
+    return airport.scheduler.now();
+}
+
+const HoldingPattern& Tower::get_holding_pattern()
+{
+    static const HoldingPattern pattern { get_circle() };
+    return pattern;
+}
+
+WaypointQueue Tower::get_instructions([[maybe_unused]] Aircraft& aircraft)
+{
+    assert(!aircraft.is_at_terminal);                                           // Released by release_aircraft
+    return get_circle();                                                        // Terminals are pushed by the tower
 }
 
 void Tower::arrived_at_terminal(const Aircraft& aircraft)
 {
     assert(aircraft.has_terminal());
-    const auto it = reserved_terminals.find(&aircraft);
-    assert(it != reserved_terminals.end());
-    airport.get_terminal(it->second).start_service(aircraft);
+    airport.start_service(aircraft.terminal, aircraft);
 }
 
-WaypointQueue Tower::instruction_aux(Aircraft& aircraft) {
-    if (aircraft.distance_to(airport.pos) >= 5) return {};            // If the aircraft is far -> cannot give him a terminal
+bool Tower::assign_terminal(Aircraft& aircraft) {
     const auto vp = airport.reserve_terminal(aircraft);            // Try to reserve a terminal
-    if (vp.first.empty()) return {};                                  // If no terminal left -> empty
-    reserved_terminals.emplace(&aircraft, vp.second);                 // Otherwise -> reserve the terminal found
-    return vp.first;                                                  // Return the path to the terminal
+    if (vp.first.empty()) return false;                               // If no terminal left -> keep waiting
+    if (aircraft.holding) aircraft.leave_holding();                   // Back to per-tick physics to land
+    aircraft.terminal  = vp.second;                                   // Otherwise -> reserve the terminal found
+    aircraft.waypoints = vp.first;                                    // And give the path to the terminal
+    aircraft.update_period = 1;                                       // Fine steps for the approach
+    return true;
+}
+
+double Tower::deadline(const Aircraft& aircraft) const
+{
+    return airport.scheduler.now() + aircraft.time_to_empty();
 }
 
-WaypointQueue Tower::reserve_terminal(Aircraft& aircraft)
+void Tower::request_terminal(Aircraft& aircraft)
 {
-    return aircraft.has_terminal() ? WaypointQueue {} : instruction_aux(aircraft);
+    assert(!aircraft.is_waiting_terminal() && !aircraft.has_terminal());
+    if (arrival_queue.empty() && assign_terminal(aircraft)) return;   // Nobody is waiting before it
+    arrival_queue.push(aircraft, deadline(aircraft));
 }
 
-void Tower::on_aircraft_crash(const Aircraft& aircraft) {
-    const auto it = reserved_terminals.find(&aircraft);
-    if (it == reserved_terminals.end()) {
-        return;
+void Tower::update_deadline(Aircraft& aircraft)
+{
+    arrival_queue.update(aircraft, deadline(aircraft));
+}
+
+void Tower::on_terminal_freed()
+{
+    while (!arrival_queue.empty() && assign_terminal(arrival_queue.top())) {
+        arrival_queue.pop();
     }
-    reserved_terminals.erase(it);
-    airport.on_aircraft_crash(aircraft);
+}
+
+void Tower::release_aircraft(const size_t terminal_num)
+{
+    Terminal& terminal = airport.get_terminal(terminal_num);
+    Aircraft* aircraft = airport.get_aircraft(terminal_num);
+    if (aircraft == nullptr || terminal.is_servicing()) return;                 // Stale event
+    terminal.finish_service(*aircraft);                                         // Remove the aircraft from terminal
+    aircraft->terminal       = Aircraft::NO_TERMINAL;                           // Remove the terminal from reserved
+    aircraft->is_at_terminal = false;
+    aircraft->serviced       = true;
+    aircraft->waypoints      = airport.start_path(terminal_num);               // Create a path to let the aircraft fly
+    on_terminal_freed();
+}
+
+void Tower::on_lifecycle_events(const std::vector<LifecycleEvent>& events)
+{
+    // every crashed aircraft leaves the queue before the terminals they freed are given away, so that
+    // none goes to an aircraft crashing later in the batch
+    bool freed = false;
+    for (const auto& event: events) {
+        if (event.kind == LifecycleKind::crashed) freed |= drop_aircraft(*event.aircraft);
+    }
+    if (freed) on_terminal_freed();
+    for (const auto& event: events) {
+        if (event.kind == LifecycleKind::arrived_at_terminal) arrived_at_terminal(*event.aircraft);
+    }                                                                           // Departed: freed at release
+}
+
+bool Tower::drop_aircraft(Aircraft& aircraft) {
+    if (aircraft.is_waiting_terminal()) {
+        arrival_queue.remove(aircraft);
+        return false;
+    }
+    if (!aircraft.has_terminal()) {
+        return false;
+    }
+    airport.on_aircraft_crash(aircraft.terminal);                               // The reservation is on the aircraft
+    aircraft.terminal = Aircraft::NO_TERMINAL;
+    return true;
+}
+
+void Tower::on_aircraft_crash(Aircraft& aircraft) {
+    if (drop_aircraft(aircraft)) on_terminal_freed();
 }
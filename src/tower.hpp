@@ -1,37 +1,52 @@
 #pragma once
 
+#include "arrival_scheduler.hpp"
+#include "config.hpp"
+#include "holding_pattern.hpp"
+#include "lifecycle_bus.hpp"
 #include "waypoint.hpp"
 
-#include <algorithm>
-#include <unordered_map>
-#include <utility>
-#include <vector>
 
 class Airport;
 class Aircraft;
 class Terminal;
 
-class Tower
+class Tower : public LifecycleSubscriber
 {
 private:
-    using AircraftToTerminal = std::unordered_map<const Aircraft*, size_t>;
-
     Airport& airport;
-    // aircrafts may reserve a terminal
-    // if so, we need to save the terminal number in order to liberate it when the craft leaves
-    AircraftToTerminal reserved_terminals = {};
+    // aircraft waiting for a terminal, the one running out of fuel first is served first
+    ArrivalScheduler arrival_queue = {};
 
-    static WaypointQueue get_circle();
-    WaypointQueue instruction_aux(Aircraft&);
+    static const WaypointQueue& get_circle();
+    // reserve a free terminal and push the path to reach it to the aircraft
+    bool assign_terminal(Aircraft&);
+    // a terminal has been freed: give it to the aircraft with the earliest deadline
+    void on_terminal_freed();
+    // take the crashed aircraft out of the queue or free its terminal, return true in the latter case
+    bool drop_aircraft(Aircraft& aircraft);
+    // time at which the aircraft runs out of fuel
+    [[nodiscard]] double deadline(const Aircraft&) const;
 public:
-    ~Tower() = default;
+    ~Tower() override = default;
     Tower(const Tower&) = delete;
     Tower& operator=(const Tower&) = delete;
-    explicit Tower(Airport& airport_) : airport { airport_ } {}
+    explicit Tower(Airport& airport_);
 
+    [[nodiscard]] const Point3D& get_position() const;
+    [[nodiscard]] double now() const;
+    // closed-form version of the circle given to the aircraft waiting for a terminal
+    static const HoldingPattern& get_holding_pattern();
     // produce instructions for aircraft
     WaypointQueue get_instructions(Aircraft& aircraft);
     void arrived_at_terminal(const Aircraft& aircraft);
-    WaypointQueue reserve_terminal(Aircraft& aircraft);
-    void on_aircraft_crash(const Aircraft& aircraft);
+    // start the service of the landed aircraft, free the terminals of the crashed ones
+    void on_lifecycle_events(const std::vector<LifecycleEvent>& events) override;
+    // the aircraft at the terminal is done: free the terminal and give it a path to take off
+    void release_aircraft(size_t terminal_num);
+    // called once when the aircraft enters the airport's area: it gets a terminal now or when one is freed
+    void request_terminal(Aircraft& aircraft);
+    // recompute the deadline of a waiting aircraft
+    void update_deadline(Aircraft& aircraft);
+    void on_aircraft_crash(Aircraft& aircraft);
 };
@@ -7,28 +7,71 @@
 #include "img/image.hpp"
 #include "img/media_path.hpp"
 #include "AircraftFactory.h"
+#include "allocation.hpp"
+#include "GL/frame_writer.hpp"
+#include "GL/glyphs.hpp"
+#include "GL/label_placer.hpp"
+#include "GL/perf_hud.hpp"
+#include "GL/render_bench.hpp"
+#include "GL/software_renderer.hpp"
+#include "GL/trails.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <cstdio>
 #include <cstdlib>
 #include <ctime>
+#include <sstream>
+#include <stdexcept>
 
 using namespace std::string_literals;
 
-TowerSimulation::TowerSimulation(int argc, char** argv) :
-    help { (argc > 1) && (std::string { argv[1] } == "--help"s || std::string { argv[1] } == "-h"s) }
+TowerSimulation::TowerSimulation(int argc, char** argv)
 {
     MediaPath::initialize(argv[0]);
-    data_path = help && argc > 2 ? argv[2] : argc > 1 ? argv[1] : "";
+    for (int i = 1; i < argc && !help; i++) {
+        const std::string arg { argv[i] };
+        try {
+            if (arg == "--help"s || arg == "-h"s) help = true;
+            else if (arg.rfind("--capture="s, 0) == 0) capture_path = arg.substr(10);
+            else if (arg.rfind("--every="s, 0) == 0) capture_every = std::max(static_cast<unsigned>(std::stoul(arg.substr(8))), 1u);
+            else if (arg.rfind("--ticks="s, 0) == 0) capture_ticks = std::stoul(arg.substr(8));
+            else if (arg == "--bench"s) bench_counts.assign(BENCH_COUNTS.begin(), BENCH_COUNTS.end());
+            else if (arg.rfind("--bench="s, 0) == 0) {
+                std::istringstream counts { arg.substr(8) };
+                for (std::string count; std::getline(counts, count, ',');) bench_counts.emplace_back(std::stoul(count));
+            }
+            else data_path = arg;
+        } catch (const std::logic_error&) {                    // std::stoul: not a number, or out of range
+            std::cout << "Invalid option: " << arg << std::endl;
+            help = true;                                        // Show the usage instead of running
+        }
+    }
     std::srand(static_cast<unsigned int>(std::time(nullptr)));
-    GL::init_gl(argc, argv, "Airport Tower Simulation");
+    if (!help && capture_path.empty() && bench_counts.empty()) {
+        GL::init_gl(argc, argv, "Airport Tower Simulation");   // Headless otherwise
+    }
     aircraft_manager = std::make_unique<AircraftManager>();
+    event_scheduler  = std::make_unique<EventScheduler>();
 
     create_keystrokes();
 }
 void TowerSimulation::create_random_aircraft()
 {
     assert(airport); // make sure the airport is initialized before creating aircraft
-    aircraft_manager->add_aircraft(aircraft_factory->create_aircraft(airport->get_tower()));
+    aircraft_factory->create_aircraft(airport->get_tower(), *aircraft_manager);
+}
+
+void TowerSimulation::skip_quiet_period()
+{
+    if (aircraft_manager->count_airborne() > 0) {
+        std::cout << "Cannot skip: aircraft are flying" << std::endl;
+        return;
+    }
+    const double delay = event_scheduler->time_to_next_event();
+    if (std::isinf(delay) || delay <= 0) return;
+    GL::advance(delay);
 }
 
 void TowerSimulation::display_airline(unsigned number) {
@@ -40,18 +83,32 @@ void TowerSimulation::display_airline(unsigned number) {
 
 void TowerSimulation::create_keystrokes()
 {
-    GL::keystrokes.emplace('x', []() { GL::exit_loop(); });
-    GL::keystrokes.emplace('q', []() { GL::exit_loop(); });
+    GL::ui_keystrokes.emplace('x', []() { GL::exit_loop(); });
+    GL::ui_keystrokes.emplace('q', []() { GL::exit_loop(); });
     GL::keystrokes.emplace('c', [this]() { create_random_aircraft(); });
-    GL::keystrokes.emplace('+', []() { GL::change_zoom(0.95f); });
-    GL::keystrokes.emplace('-', []() { GL::change_zoom(1.05f); });
-    GL::keystrokes.emplace('f', []() { GL::toggle_fullscreen(); });
+    GL::ui_keystrokes.emplace('+', []() { GL::change_zoom(0.95f); });
+    GL::ui_keystrokes.emplace('-', []() { GL::change_zoom(1.05f); });
+    GL::ui_keystrokes.emplace('f', []() { GL::toggle_fullscreen(); });
+    GL::ui_keystrokes.emplace('z', []() { GL::camera.reset(); });
     GL::keystrokes.emplace('i', []() { GL::change_framerate(+1); });
     GL::keystrokes.emplace('d', []() { GL::change_framerate(-1); });
     GL::keystrokes.emplace('p', []() { GL::pause(); });
+    GL::keystrokes.emplace('r', []() { GL::display_rates(); });
+    GL::keystrokes.emplace('h', []() { GL::toggle_heatmap(); });
+    GL::keystrokes.emplace('n', []() { GL::labels_enabled = !GL::labels_enabled; });
+    GL::ui_keystrokes.emplace('v', []() { GL::perf_hud.toggle(); });
+    GL::ui_keystrokes.emplace('w', []() { GL::perf_hud.dump(HUD_DUMP_FILE); });
+    GL::keystrokes.emplace('t', []() {
+        GL::trails_enabled = !GL::trails_enabled;
+        GL::trails.clear_all();                                 // No segment across the time they were off
+    });
     GL::keystrokes.emplace('o', []() { GL::change_framerate_modifier(1.01); });
     GL::keystrokes.emplace('l', []() { GL::change_framerate_modifier(0.99); });
     GL::keystrokes.emplace('m', [this]() { aircraft_manager->display_crash_number(); });
+    GL::keystrokes.emplace('g', [this]() { assert(traffic_generator); traffic_generator->next_process(); });
+    GL::keystrokes.emplace('s', [this]() { assert(traffic_generator); traffic_generator->next_stress_level(); });
+    GL::keystrokes.emplace('a', []() { alloc::display_counters(); });
+    GL::keystrokes.emplace('j', [this]() { skip_quiet_period(); });
     for (auto i = 0; i < 8; i++) {
         GL::keystrokes.emplace('0'+i, [this, i]() { display_airline(i); });
     }
@@ -62,15 +119,44 @@ void TowerSimulation::display_help()
     std::cout << "This is an airport tower simulator" << std::endl
               << "the following keystrokes have meaning:" << std::endl;
 
+    for (const auto& [key, action] : GL::ui_keystrokes) { std::cout << key << ' '; }
     for (const auto& [key, action] : GL::keystrokes) { std::cout << key << ' '; }
-    std::cout << std::endl;
+    std::cout << std::endl
+              << "options: [aircraft types file] [--capture=<frames.y4m | frame.png> [--every=<ticks>] [--ticks=<ticks>]]"
+              << " [--bench[=<aircraft count>,...]]" << std::endl;
+}
+
+void TowerSimulation::capture()
+{
+    GL::atlas.build(false);                                     // No GL context: the pixels stay on the CPU
+    GL::SoftwareRenderer renderer { GL::atlas, CAPTURE_WIDTH, CAPTURE_HEIGHT };
+    GL::camera.resize(CAPTURE_WIDTH, CAPTURE_HEIGHT);
+    const auto view = GL::camera.view(0.f);
+    traffic_generator->set_process(ArrivalProcess::poisson);    // Nobody can press the keys
+    if (capture_path.extension() == ".y4m") {
+        GL::Y4mWriter video { capture_path, CAPTURE_WIDTH, CAPTURE_HEIGHT, GL::ticks_per_sec, capture_every };
+        GL::run_headless(capture_ticks, capture_every, [&renderer, &video, &view](const GL::Snapshot& frame) {
+            renderer.render(frame, view);
+            video.write(renderer.get_pixels());
+        });
+    } else {
+        unsigned long number = 0;
+        GL::run_headless(capture_ticks, capture_every, [this, &renderer, &view, &number](const GL::Snapshot& frame) {
+            renderer.render(frame, view);
+            char suffix[32];
+            std::snprintf(suffix, sizeof(suffix), "_%05lu", number++);
+            auto path = capture_path;
+            path.replace_filename(capture_path.stem().string() + suffix + capture_path.extension().string());
+            GL::write_png(path, renderer.get_pixels(), renderer.get_width(), renderer.get_height());
+        });
+    }
 }
 
 void TowerSimulation::init_airport()
 {
     airport = std::make_unique<Airport>(one_lane_airport, Point3D { 0.f, 0.f, 0.f },
-                            new img::Image { one_lane_airport_sprite_path.get_full_path() }, *aircraft_manager);
-    GL::move_queue.emplace(airport.get());
+                            new img::Image { one_lane_airport_sprite_path.get_full_path() }, *aircraft_manager,
+                            *event_scheduler);
 }
 
 void TowerSimulation::launch()
@@ -83,6 +169,22 @@ void TowerSimulation::launch()
     }
     init_airport();
     aircraft_factory = data_path.empty() ? std::make_unique<AircraftFactory>() : AircraftFactory::LoadTypes(MediaPath {data_path});
+    traffic_generator = std::make_unique<TrafficGenerator>(*aircraft_factory, *aircraft_manager, airport->get_tower());
+    GL::register_glyphs();
+    GL::sample_world = [this](GL::PerfSample& sample) {
+        sample.fleet          = aircraft_manager->count();
+        sample.circling       = aircraft_manager->count_in_phase(FlightPhase::holding);
+        sample.free_terminals = airport->count_free_terminals();
+    };
+    if (!capture_path.empty()) {
+        capture();
+        return;
+    }
+    if (!bench_counts.empty()) {
+        GL::run_render_bench(bench_counts);
+        return;
+    }
 
+    GL::atlas.build();                                          // Every sprite is known now
     GL::loop();
 }
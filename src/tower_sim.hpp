@@ -1,31 +1,48 @@
 #pragma once
 
+#include <filesystem>
 #include <memory>
 #include <string>
+#include <vector>
 
 struct AircraftType;
 
 #include "airport.hpp"
+#include "config.hpp"
 #include "AircraftManager.hpp"
 #include "AircraftFactory.h"
+#include "event_scheduler.hpp"
+#include "traffic_generator.hpp"
 
 class TowerSimulation
 {
 private:
     bool help        = false;
+    std::unique_ptr<EventScheduler> event_scheduler;
     std::unique_ptr<Airport> airport;
     std::unique_ptr<AircraftManager> aircraft_manager;
     std::unique_ptr<AircraftFactory> aircraft_factory;
+    std::unique_ptr<TrafficGenerator> traffic_generator;
 
     std::string data_path;
+    // headless capture of the run (see GL::run_headless), off when the path is empty
+    std::filesystem::path capture_path;
+    unsigned capture_every      = CAPTURE_EVERY;
+    unsigned long capture_ticks = CAPTURE_TICKS;
+    // aircraft counts of the render benchmark (see GL::run_render_bench), off when empty
+    std::vector<size_t> bench_counts;
 
     void create_random_aircraft();
+    // jump to the next ground event when no aircraft is flying
+    void skip_quiet_period();
 
     void create_keystrokes();
     static void display_help() ;
     void display_airline(unsigned);
 
     void init_airport();
+    // draw the snapshots of a headless run with the software renderer and write them to capture_path
+    void capture();
 public:
     ~TowerSimulation() = default;
     TowerSimulation(int argc, char** argv);
@@ -0,0 +1,99 @@
+#include "traffic_generator.hpp"
+
+#include "AircraftFactory.h"
+#include "AircraftManager.hpp"
+#include "GL/displayable.hpp"
+#include "GL/perf_hud.hpp"
+#include "allocation.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+
+TrafficGenerator::TrafficGenerator(AircraftFactory& factory_, AircraftManager& manager_, Tower& tower_,
+                                   const double rate_) :
+    factory { factory_ },
+    manager { manager_ },
+    tower { tower_ },
+    base_rate { rate_ }
+{
+    assert(base_rate >= 0);
+    GL::move_queue.emplace(this);
+}
+
+std::string_view TrafficGenerator::process_name(const ArrivalProcess p)
+{
+    switch (p) {
+        case ArrivalProcess::poisson: return "poisson";
+        case ArrivalProcess::bursty: return "bursty";
+        case ArrivalProcess::profile: return "time of day profile";
+        default: return "none";
+    }
+}
+
+void TrafficGenerator::set_process(const ArrivalProcess p)
+{
+    process  = p;
+    in_burst = false;
+    state_end = clock;
+    std::cout << "Arrival process : " << process_name(process) << std::endl;
+}
+
+void TrafficGenerator::next_process()
+{
+    set_process(static_cast<ArrivalProcess>((static_cast<int>(process) + 1) % 4));
+}
+
+void TrafficGenerator::next_stress_level()
+{
+    stress_level  = (stress_level + 1) % STRESS_LEVELS.size();
+    stress_target = STRESS_LEVELS[stress_level];
+    manager.reserve(stress_target);                             // Avoid reallocations while filling up
+    std::cout << "Stress mode : " << stress_target << " live aircraft" << std::endl;
+}
+
+// Arrival rate at the current time, updating the state of the bursty process if needed
+double TrafficGenerator::current_rate()
+{
+    switch (process) {
+        case ArrivalProcess::poisson:
+            return base_rate;
+        case ArrivalProcess::bursty:
+            while (clock >= state_end) {                        // The state durations are exponential
+                in_burst = !in_burst;
+                const double mean = in_burst ? MEAN_BURST_DURATION : MEAN_CALM_DURATION;
+                state_end += std::exponential_distribution<double> { 1. / mean }(engine);
+            }
+            return base_rate * (in_burst ? BURST_RATE_FACTOR : CALM_RATE_FACTOR);
+        case ArrivalProcess::profile: {
+            const double day_time = std::fmod(clock, DAY_DURATION);
+            const auto hour = static_cast<size_t>(day_time * HOURLY_TRAFFIC_PROFILE.size() / DAY_DURATION);
+            return base_rate * HOURLY_TRAFFIC_PROFILE[std::min(hour, HOURLY_TRAFFIC_PROFILE.size() - 1)];
+        }
+        default:
+            return 0;
+    }
+}
+
+void TrafficGenerator::sustain_stress_level()
+{
+    const size_t live = manager.count();
+    if (live >= stress_target) return;
+    const size_t batch = std::min(stress_target - live, MAX_STRESS_BATCH);
+    factory.create_aircrafts(tower, manager, batch);
+}
+
+void TrafficGenerator::move(const double dt)
+{
+    assert(dt > 0);
+    const alloc::PhaseGuard phase { alloc::Phase::traffic };
+    const GL::StageTimer timer { GL::Stage::traffic };
+    clock += dt;
+    const double rate = current_rate();
+    if (rate > 0) {                                             // Number of arrivals during dt follows a Poisson law
+        const auto arrivals = std::poisson_distribution<size_t> { rate * dt }(engine);
+        if (arrivals > 0) factory.create_aircrafts(tower, manager, arrivals);
+    }
+    if (stress_target > 0) sustain_stress_level();
+}
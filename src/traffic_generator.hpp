@@ -0,0 +1,48 @@
+#pragma once
+
+#include "GL/dynamic_object.hpp"
+#include "config.hpp"
+
+#include <random>
+#include <string_view>
+
+class AircraftFactory;
+class AircraftManager;
+class Tower;
+
+// Random process followed by the arrivals
+enum class ArrivalProcess { none, poisson, bursty, profile };
+
+class TrafficGenerator : public GL::DynamicObject
+{
+public:
+    TrafficGenerator(AircraftFactory& factory_, AircraftManager& manager_, Tower& tower_,
+                     const double rate_ = DEFAULT_ARRIVAL_RATE);
+    ~TrafficGenerator() override = default;
+    TrafficGenerator(const TrafficGenerator&) = delete;
+    TrafficGenerator& operator=(const TrafficGenerator&) = delete;
+
+    void move(double) override;
+    [[nodiscard]] unsigned update_period() const override { return TRAFFIC_UPDATE_PERIOD; }
+    void set_process(ArrivalProcess);
+    void next_process();                    // Cycle through the arrival processes
+    void next_stress_level();               // Cycle through STRESS_LEVELS
+    [[nodiscard]] ArrivalProcess get_process() const { return process; }
+    [[nodiscard]] size_t get_stress_target() const { return stress_target; }
+private:
+    AircraftFactory& factory;
+    AircraftManager& manager;
+    Tower& tower;
+    const double base_rate;                 // Mean number of arrivals per unit of time
+    ArrivalProcess process = ArrivalProcess::none;
+    size_t stress_level    = 0;             // Index in STRESS_LEVELS
+    size_t stress_target   = 0;             // Number of live aircraft to sustain (0 = disabled)
+    double clock           = 0;             // Time elapsed since the generator creation
+    bool in_burst          = false;         // State of the bursty process
+    double state_end       = 0;             // End of the current bursty state
+    std::mt19937 engine { static_cast<unsigned>(std::rand()) };
+
+    [[nodiscard]] double current_rate();
+    void sustain_stress_level();
+    static std::string_view process_name(ArrivalProcess);
+};
@@ -1,9 +1,8 @@
 #pragma once
 
+#include "fixed_deque.hpp"
 #include "geometry.hpp"
 
-#include <deque>
-
 enum WaypointType
 {
     wp_air,
@@ -19,6 +18,7 @@ friend std::ostream& operator<<(std::ostream& s, const Waypoint& w) {
 public:
     WaypointType type;
 
+    Waypoint() : Point3D { 0.f, 0.f, 0.f }, type { wp_air } {}
     explicit Waypoint(const Point3D& position, const WaypointType type_ = wp_air) :
             Point3D { position }, type { type_ }
     {}
@@ -36,4 +36,6 @@ public:
     [[nodiscard]] bool is_at_terminal() const { return type == wp_terminal; }
 };
 
-using WaypointQueue = std::deque<Waypoint>;
\ No newline at end of file
+// the longest path given by the tower (runway to terminal) has 6 waypoints
+constexpr size_t MAX_WAYPOINTS = 8;
+using WaypointQueue = FixedDeque<Waypoint, MAX_WAYPOINTS>;
\ No newline at end of file